@@ -0,0 +1,22 @@
+#!/bin/bash
+# Generates src/include/vga_palette.h from the GIMP palette of the default mode 13h colors
+
+awk 'BEGIN {
+	print "#ifndef VGA_PALETTE_H"
+	print "#define VGA_PALETTE_H"
+	print ""
+	print "#include \"stdint.h\""
+	print ""
+	print "//Default mode 13h palette as 8 bit RGB, generated from resources/vgaGimpPalette.gpl"
+	print "static const uint8_t vga_palette[256][3] = {"
+	n = 0
+}
+/^ *[0-9]+ +[0-9]+ +[0-9]+/ && n < 256 {
+	printf "  { %3d, %3d, %3d },\n", $1, $2, $3
+	n++
+}
+END {
+	print "};"
+	print ""
+	print "#endif"
+}' vgaGimpPalette.gpl > ../src/include/vga_palette.h
@@ -1,16 +1,10 @@
 #!/bin/bash
 
-java -classpath ../tools/ BmpToArray snake_head_0.bmp 8 8 sprite_snake_head_0 >> output.c
-java -classpath ../tools/ BmpToArray snake_head_1.bmp 8 8 sprite_snake_head_1 >> output.c
-java -classpath ../tools/ BmpToArray snake_head_2.bmp 8 8 sprite_snake_head_2 >> output.c
-java -classpath ../tools/ BmpToArray snake_head_3.bmp 8 8 sprite_snake_head_3 >> output.c
-
-printf "\n" >> output.c
-
-java -classpath ../tools/ BmpToArray snake_body_0.bmp 8 8 sprite_snake_body_0 >> output.c
-java -classpath ../tools/ BmpToArray snake_body_1.bmp 8 8 sprite_snake_body_1 >> output.c
-java -classpath ../tools/ BmpToArray snake_body_2.bmp 8 8 sprite_snake_body_2 >> output.c
-java -classpath ../tools/ BmpToArray snake_body_3.bmp 8 8 sprite_snake_body_3 >> output.c
+# One image per directional sprite, the kernel rotates it with sprite_compile_oriented.
+# The south body has its own scale pattern, no rotation of the north one matches it.
+java -classpath ../tools/ BmpToArray snake_head.bmp 8 8 sprite_snake_head >> output.c
+java -classpath ../tools/ BmpToArray snake_body.bmp 8 8 sprite_snake_body >> output.c
+java -classpath ../tools/ BmpToArray snake_body_south.bmp 8 8 sprite_snake_body_south >> output.c
 
 printf "\n" >> output.c
 
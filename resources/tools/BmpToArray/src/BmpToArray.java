@@ -136,7 +136,7 @@ public class BmpToArray
             int image_height = y;
             int padding_bytes = image_width % 4;
 
-            String arrayBegin = "uint8_t " + args[3] + " [" + (image_width * image_height) + "] = {";
+            String arrayBegin = "const uint8_t " + args[3] + " [" + (image_width * image_height) + "] = {";
             writer.write(arrayBegin);
             System.out.print(arrayBegin);
 
@@ -0,0 +1,115 @@
+#!/usr/bin/env python3
+# Decodes a SnakeOS frame capture (see src/include/capture.h) into PNG files.
+#
+#   qemu-system-i386 -kernel kernel.bin -append capture=com2 \
+#     -serial file:serial.log -serial file:capture.bin
+#   ./capture_decode.py capture.bin frames/
+#
+# The frames can be joined into a video or gif afterwards, e.g. with
+#   ffmpeg -framerate 60 -i frames/frame_%05d.png snake.gif
+
+import os
+import struct
+import sys
+import zlib
+
+MAGIC = b"SNKF"
+HEADER = struct.Struct("<4sHHIIB")
+FLAG_KEY = 0x01
+FLAG_PALETTE = 0x02
+
+
+def decode_delta(data, pos, size):
+    delta = bytearray(size)
+    i = 0
+    while i < size:
+        code = data[pos]
+        pos += 1
+        if code < 0x80:
+            count = code + 1
+            delta[i:i + count] = data[pos:pos + count]
+            pos += count
+        elif code < 0xC0:
+            count = (code & 0x3F) + 3
+            delta[i:i + count] = bytes([data[pos]]) * count
+            pos += 1
+        else:
+            count = (((code & 0x3F) << 8) | data[pos]) + 1
+            pos += 1
+        i += count
+    if i != size:
+        raise ValueError("frame overruns its size")
+    return delta, pos
+
+
+def png_chunk(kind, payload):
+    chunk = kind + payload
+    return struct.pack(">I", len(payload)) + chunk + struct.pack(">I", zlib.crc32(chunk) & 0xFFFFFFFF)
+
+
+def write_png(path, width, height, pixels, palette):
+    rows = b"".join(b"\0" + bytes(pixels[y * width:(y + 1) * width]) for y in range(height))
+    with open(path, "wb") as f:
+        f.write(b"\x89PNG\r\n\x1a\n")
+        f.write(png_chunk(b"IHDR", struct.pack(">IIBBBBB", width, height, 8, 3, 0, 0, 0)))
+        f.write(png_chunk(b"PLTE", bytes(palette)))
+        f.write(png_chunk(b"IDAT", zlib.compress(rows, 9)))
+        f.write(png_chunk(b"IEND", b""))
+
+
+def main():
+    if len(sys.argv) != 3:
+        print("usage: %s capture.bin output_dir" % sys.argv[0])
+        return 1
+
+    with open(sys.argv[1], "rb") as f:
+        data = f.read()
+    os.makedirs(sys.argv[2], exist_ok=True)
+
+    pixels = None
+    palette = None
+    pos = 0
+    written = 0
+    #The kernel sends the time modulo 2^32 us
+    last_time = 0
+    time_offset = 0
+    while True:
+        pos = data.find(MAGIC, pos)
+        if pos < 0 or pos + HEADER.size > len(data):
+            break
+        start = pos
+        _, width, height, frame, time_us, flags = HEADER.unpack_from(data, pos)
+        pos += HEADER.size
+
+        try:
+            if flags & FLAG_PALETTE:
+                palette = data[pos:pos + 768]
+                pos += 768
+            delta, pos = decode_delta(data, pos, width * height)
+        except (IndexError, ValueError):
+            #Cut off or garbled, look for the next frame
+            pos = start + 1
+            continue
+
+        #Until the first key frame there is nothing to apply the delta to
+        if flags & FLAG_KEY:
+            pixels = bytearray(width * height)
+        if pixels is None or palette is None or len(pixels) != width * height:
+            continue
+
+        for i, value in enumerate(delta):
+            if value:
+                pixels[i] ^= value
+        write_png(os.path.join(sys.argv[2], "frame_%05d.png" % frame), width, height, pixels, palette)
+        written += 1
+        if time_us < last_time:
+            time_offset += 1 << 32
+        last_time = time_us
+        print("frame %5d %8.3f s %6d bytes%s" % (frame, (time_offset + time_us) / 1000000.0, pos - start, " key" if flags & FLAG_KEY else ""))
+
+    print("%d frames written" % written)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
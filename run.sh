@@ -7,6 +7,8 @@ fi
 
 cd bin
 #-append cmdline use 'cmdline' as kernel command line
+#-append terminal=com1 -serial stdio plays the game in this terminal
+#-append capture=com2 -serial file:capture.bin streams the frames, see resources/tools/capture_decode.py
 #qemu debug log -d int,cpu_reset
 qemu-system-i386 -kernel kernel.bin -serial file:serial.log -d cpu_reset
 exit 0
@@ -0,0 +1,92 @@
+#include "arena.h"
+
+#include "mm.h"
+#include "stdio.h"
+
+#define ARENA_ALIGNMENT 8
+
+struct arena_chunk
+{
+	struct arena_chunk *next;
+	uint32_t size;
+};
+
+#define ARENA_CHUNK_HEADER ((sizeof(struct arena_chunk) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+struct arena frame_arena;
+
+static struct arena_chunk *arena_new_chunk(struct arena *arena)
+{
+	struct arena_chunk *chunk = (struct arena_chunk *) mm_alloc_pages(arena->chunk_order);
+	if(chunk == NULL)
+	{
+		printf("arena: %s out of memory\n", arena->name);
+		return NULL;
+	}
+
+	chunk->next = NULL;
+	chunk->size = PAGE_SIZE << arena->chunk_order;
+	return chunk;
+}
+
+void arena_init(struct arena *arena, const char *name, uint32_t chunk_order)
+{
+	arena->name = name;
+	arena->chunk_order = chunk_order;
+	arena->first = arena_new_chunk(arena);
+	arena->current = arena->first;
+	arena->offset = ARENA_CHUNK_HEADER;
+	arena->used = 0;
+	arena->peak = 0;
+}
+
+void *arena_alloc(struct arena *arena, size_t size)
+{
+	if(arena->current == NULL)return NULL;
+
+	size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+	if(size > (PAGE_SIZE << arena->chunk_order) - ARENA_CHUNK_HEADER)
+	{
+		printf("arena: %d Bytes do not fit into a chunk of %s\n", size, arena->name);
+		return NULL;
+	}
+
+	if(arena->offset + size > arena->current->size)
+	{
+		//Chunks stay chained after a reset and are reused before new ones
+		if(arena->current->next == NULL)
+		{
+			arena->current->next = arena_new_chunk(arena);
+			if(arena->current->next == NULL)return NULL;
+		}
+		arena->current = arena->current->next;
+		arena->offset = ARENA_CHUNK_HEADER;
+	}
+
+	void *memory = (uint8_t *)arena->current + arena->offset;
+	arena->offset += size;
+	arena->used += size;
+	if(arena->used > arena->peak)arena->peak = arena->used;
+
+	return memory;
+}
+
+void arena_reset(struct arena *arena)
+{
+	arena->current = arena->first;
+	arena->offset = ARENA_CHUNK_HEADER;
+	arena->used = 0;
+}
+
+struct arena_marker arena_mark(struct arena *arena)
+{
+	struct arena_marker marker = { arena->current, arena->offset, arena->used };
+	return marker;
+}
+
+void arena_release(struct arena *arena, struct arena_marker marker)
+{
+	arena->current = marker.chunk;
+	arena->offset = marker.offset;
+	arena->used = marker.used;
+}
@@ -0,0 +1,242 @@
+/*
+ * Headless frame capture.
+ * With capture=com2 on the kernel command line every presented frame is
+ * sent over COM2. Each frame is XORed with the previous one, unchanged
+ * pixels then become long zero runs that the RLE codes skip in two
+ * bytes. A game frame usually costs a few hundred bytes instead of 64000.
+ * resources/tools/capture_decode.py turns the stream into PNG files.
+ * Key frames are coded against black. The reference then gets fresh
+ * frames from the pre-cleared pool of mm_alloc_zeroed instead of being
+ * cleared in the middle of a present.
+ */
+#include "capture.h"
+
+#include "stdio.h"
+#include "serial.h"
+#include "cmdline.h"
+#include "mm.h"
+#include "cpu.h"
+#include "tsc.h"
+#include "video.h"
+#include "palette.h"
+
+#define CAPTURE_FRAME_SIZE (SCREEN_WIDTH * SCREEN_HEIGHT)
+#define CAPTURE_PAGES ((CAPTURE_FRAME_SIZE + PAGE_SIZE - 1) / PAGE_SIZE)
+//Interval at which the timestamp origin moves forward
+#define CAPTURE_REBASE_SECONDS 3600
+
+static bool enabled = false;
+static uint16_t port = COM2;
+static uint32_t frame = 0;
+static uint64_t start_tsc = 0;
+static uint32_t time_base_us = 0;
+static uint32_t stream_bytes = 0;
+
+//Last frame sent, the delta reference, one frame per 4 KB of pixels
+static uint8_t *previous[CAPTURE_PAGES];
+static uint8_t sent_palette[PALETTE_SIZE * 3];
+
+//Literal bytes wait here until the length of the run is known
+static uint8_t literal[CAPTURE_LITERAL_MAX];
+static uint8_t literal_length = 0;
+
+static inline void put_byte(uint8_t value)
+{
+	write_serial_port(port, value);
+	stream_bytes++;
+}
+
+static void put_u16(uint16_t value)
+{
+	put_byte(value);
+	put_byte(value >> 8);
+}
+
+static void put_u32(uint32_t value)
+{
+	put_u16(value);
+	put_u16(value >> 16);
+}
+
+static inline uint8_t reference(uint32_t i)
+{
+	return previous[i / PAGE_SIZE][i % PAGE_SIZE];
+}
+
+//Bytes of pixel i and on that lie in the same reference frame
+static inline uint32_t page_rest(uint32_t i)
+{
+	uint32_t rest = PAGE_SIZE - i % PAGE_SIZE;
+	return i + rest > CAPTURE_FRAME_SIZE ? CAPTURE_FRAME_SIZE - i : rest;
+}
+
+//Swap in cleared frames, false if memory ran out
+static bool reference_clear(void)
+{
+	for(uint32_t page = 0; page < CAPTURE_PAGES; page++)
+	{
+		if(previous[page] != NULL)mm_free(previous[page]);
+		previous[page] = mm_alloc_zeroed();
+		if(previous[page] == NULL)return false;
+	}
+	return true;
+}
+
+static bool reference_equal(const uint8_t *buffer)
+{
+	for(uint32_t i = 0; i < CAPTURE_FRAME_SIZE; i += page_rest(i))
+	{
+		if(memcmp(previous[i / PAGE_SIZE], buffer + i, page_rest(i)) != 0)return false;
+	}
+	return true;
+}
+
+static void reference_store(const uint8_t *buffer)
+{
+	for(uint32_t i = 0; i < CAPTURE_FRAME_SIZE; i += page_rest(i))
+	{
+		memcpy(previous[i / PAGE_SIZE], buffer + i, page_rest(i));
+	}
+}
+
+static void flush_literal(void)
+{
+	if(literal_length == 0)return;
+	put_byte(literal_length - 1);
+	for(uint8_t i = 0; i < literal_length; i++)put_byte(literal[i]);
+	literal_length = 0;
+}
+
+//capture=com1 to com4
+void init_capture(void)
+{
+	const char *option = cmdline_get("capture");
+	if(option == NULL)return;
+
+	static const uint16_t ports[] = {COM1, COM2, COM3, COM4};
+	if(strncmp(option, "com", 3) != 0 || option[3] < '1' || option[3] > '4' || option[4] != '\0')
+	{
+		printf("capture: unknown port %s\n", option);
+		return;
+	}
+	port = ports[option[3] - '1'];
+
+	if(!reference_clear())
+	{
+		printf("capture: no memory for the reference frame\n");
+		return;
+	}
+
+	//Log lines would land between the frames, and the log rate is too slow
+	//for key frames, so COM1 leaves the log and runs at the stream rate
+	if(port == COM1)set_serial_output(false);
+	printf("capture: streaming frames to %s\n", option);
+	init_serial_port(port, SERIAL_DIVISOR_115200);
+
+	frame = 0;
+	stream_bytes = 0;
+	start_tsc = rdtsc();
+	time_base_us = 0;
+	enabled = true;
+}
+
+//Microseconds since init_capture, wrapping at 2^32. start_tsc moves on in
+//whole hours so tsc_cycles_to_us never saturates and no time is lost.
+static uint32_t capture_time_us(void)
+{
+	uint64_t hour = (uint64_t)tsc_get_khz() * 1000 * CAPTURE_REBASE_SECONDS;
+	uint64_t now = rdtsc();
+	while(hour != 0 && now - start_tsc >= hour)
+	{
+		start_tsc += hour;
+		time_base_us += CAPTURE_REBASE_SECONDS * 1000000U;
+	}
+	return time_base_us + tsc_cycles_to_us(now - start_tsc);
+}
+
+bool capture_enabled(void)
+{
+	return enabled;
+}
+
+//Send one frame, frames without changes are left out
+void capture_frame(const uint8_t *buffer, bool palette_changed)
+{
+	if(!enabled)return;
+
+	bool key = (frame % CAPTURE_KEY_INTERVAL) == 0;
+	const uint8_t *palette = palette_get_active();
+	if(key || palette_changed)
+	{
+		palette_changed = memcmp(sent_palette, palette, sizeof(sent_palette)) != 0;
+	}
+	if(key)
+	{
+		if(frame != 0 && !reference_clear())
+		{
+			printf("capture: no memory for the reference frame, stopping\n");
+			enabled = false;
+			return;
+		}
+		palette_changed = true;
+	}
+	else if(!palette_changed && reference_equal(buffer))
+	{
+		return;
+	}
+
+	uint32_t start_bytes = stream_bytes;
+	for(int i = 0; i < 4; i++)put_byte(CAPTURE_MAGIC[i]);
+	put_u16(SCREEN_WIDTH);
+	put_u16(SCREEN_HEIGHT);
+	put_u32(frame);
+	put_u32(capture_time_us());
+	put_byte((key ? CAPTURE_FLAG_KEY : 0) | (palette_changed ? CAPTURE_FLAG_PALETTE : 0));
+	if(palette_changed)
+	{
+		memcpy(sent_palette, palette, sizeof(sent_palette));
+		for(uint32_t i = 0; i < sizeof(sent_palette); i++)put_byte(sent_palette[i]);
+	}
+
+	uint32_t i = 0;
+	while(i < CAPTURE_FRAME_SIZE)
+	{
+		uint8_t delta = buffer[i] ^ reference(i);
+
+		//Unchanged pixels, a single one is cheaper as a literal
+		uint32_t run = 0;
+		while(i + run < CAPTURE_FRAME_SIZE && run < CAPTURE_SKIP_MAX && buffer[i + run] == reference(i + run))run++;
+		if(run > 1)
+		{
+			flush_literal();
+			put_byte(0xC0 | ((run - 1) >> 8));
+			put_byte(run - 1);
+			i += run;
+			continue;
+		}
+
+		//Changed pixels with the same delta
+		run = 1;
+		while(i + run < CAPTURE_FRAME_SIZE && run < CAPTURE_REPEAT_MAX && (buffer[i + run] ^ reference(i + run)) == delta)run++;
+		if(run >= CAPTURE_REPEAT_MIN)
+		{
+			flush_literal();
+			put_byte(0x80 | (run - CAPTURE_REPEAT_MIN));
+			put_byte(delta);
+			i += run;
+			continue;
+		}
+
+		literal[literal_length++] = delta;
+		if(literal_length == CAPTURE_LITERAL_MAX)flush_literal();
+		i++;
+	}
+	flush_literal();
+
+	reference_store(buffer);
+	if(frame % CAPTURE_KEY_INTERVAL == CAPTURE_KEY_INTERVAL - 1 || key)
+	{
+		printf("capture: frame %d, %d Bytes, %d Bytes streamed\n", frame, stream_bytes - start_bytes, stream_bytes);
+	}
+	frame++;
+}
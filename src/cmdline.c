@@ -0,0 +1,63 @@
+/*
+ * Kernel command line from the boot loader.
+ * The line is copied once and split into key=value arguments separated by
+ * spaces. Arguments without a value have an empty one.
+ */
+#include "cmdline.h"
+
+#include "stdio.h"
+
+static char cmdline[CMDLINE_MAX_LENGTH];
+static const char *keys[CMDLINE_MAX_ARGS];
+static const char *values[CMDLINE_MAX_ARGS];
+static uint32_t arg_count = 0;
+
+void init_cmdline(struct multiboot_info *mb_info)
+{
+	arg_count = 0;
+	if(!(mb_info->flags & MULTIBOOT_INFO_CMDLINE) || mb_info->cmdline == 0)return;
+
+	const char *src = (const char *)(uintptr_t)mb_info->cmdline;
+	size_t length = 0;
+	while(src[length] && length < CMDLINE_MAX_LENGTH - 1)
+	{
+		cmdline[length] = src[length];
+		length++;
+	}
+	cmdline[length] = '\0';
+	printf("cmdline: %s\n", cmdline);
+
+	char *p = cmdline;
+	while(*p && arg_count < CMDLINE_MAX_ARGS)
+	{
+		while(*p == ' ')*p++ = '\0';
+		if(*p == '\0')break;
+
+		//Only the first '=' separates key and value
+		keys[arg_count] = p;
+		values[arg_count] = "";
+		bool has_value = false;
+		while(*p && *p != ' ')
+		{
+			if(*p == '=' && !has_value)
+			{
+				*p = '\0';
+				values[arg_count] = p + 1;
+				has_value = true;
+			}
+			p++;
+		}
+		arg_count++;
+	}
+}
+
+//Value of the last key=value argument with this key, NULL if there is none
+const char *cmdline_get(const char *key)
+{
+	const char *value = NULL;
+	for(uint32_t i = 0; i < arg_count; i++)
+	{
+		if(strcmp(keys[i], key) == 0)value = values[i];
+	}
+	return value;
+}
@@ -0,0 +1,137 @@
+/*
+ * Bochs/QEMU DISPI display driver.
+ * The mode is programmed through two I/O ports, no BIOS call is needed.
+ * The frame buffer is the first memory BAR of the PCI display device.
+ * The virtual screen is DISPI_PAGES times as high as the visible one,
+ * a page is shown by moving the Y offset, so presenting copies nothing
+ * to the visible page.
+ */
+#include "dispi.h"
+
+#include "stdio.h"
+#include "pci.h"
+
+static uint16_t visible_height = 0;
+
+static inline void dispi_write(uint16_t index, uint16_t value)
+{
+	outport(DISPI_INDEX, index);
+	outport(DISPI_DATA, value);
+}
+
+static inline uint16_t dispi_read(uint16_t index)
+{
+	outport(DISPI_INDEX, index);
+	return inport(DISPI_DATA);
+}
+
+//Set a mode with room for DISPI_PAGES pages, fills in the frame buffer format.
+//A width, height or bpp of 0 selects 640x400x32, which shows 320x200 at scale 2.
+bool dispi_init(uint16_t width, uint16_t height, uint8_t bpp, struct lfb_format *format)
+{
+	if(width == 0)width = 640;
+	if(height == 0)height = 400;
+	if(bpp == 0)bpp = 32;
+
+	const struct pci_device *device = pci_find_device(DISPI_PCI_VENDOR, DISPI_PCI_DEVICE);
+	if(device == NULL)
+	{
+		printf("dispi: no display adapter found\n");
+		return false;
+	}
+
+	uint16_t id = dispi_read(DISPI_INDEX_ID);
+	if((id & DISPI_ID_MASK) != DISPI_ID_BASE || id < DISPI_ID_MIN)
+	{
+		printf("dispi: unsupported interface %x\n", id);
+		return false;
+	}
+
+	uintptr_t framebuffer = pci_memory_bar(device, 0);
+	if(framebuffer == 0)
+	{
+		printf("dispi: no frame buffer BAR\n");
+		return false;
+	}
+	pci_write32(device, PCI_COMMAND, pci_read32(device, PCI_COMMAND) | PCI_COMMAND_MEMORY);
+
+	uint32_t memory = (uint32_t)dispi_read(DISPI_INDEX_VIDEO_MEMORY) * 0x10000;
+	uint32_t page_size = (uint32_t)width * height * ((bpp + 7) / 8);
+	if(page_size * DISPI_PAGES > memory)
+	{
+		printf("dispi: %dx%dx%d needs %d KB, only %d KB video memory\n", width, height, bpp,
+			page_size * DISPI_PAGES / 1024, memory / 1024);
+		return false;
+	}
+
+	dispi_write(DISPI_INDEX_ENABLE, 0);
+	dispi_write(DISPI_INDEX_XRES, width);
+	dispi_write(DISPI_INDEX_YRES, height);
+	dispi_write(DISPI_INDEX_BPP, bpp);
+	dispi_write(DISPI_INDEX_ENABLE, DISPI_ENABLED | DISPI_LFB_ENABLED);
+
+	//Enabling resets the virtual size to the visible one, set it afterwards
+	dispi_write(DISPI_INDEX_VIRT_WIDTH, width);
+	dispi_write(DISPI_INDEX_VIRT_HEIGHT, height * DISPI_PAGES);
+	dispi_write(DISPI_INDEX_X_OFFSET, 0);
+	dispi_write(DISPI_INDEX_Y_OFFSET, 0);
+
+	//The adapter may round the mode, use what it reports
+	uint16_t actual_width = dispi_read(DISPI_INDEX_XRES);
+	uint16_t actual_height = dispi_read(DISPI_INDEX_YRES);
+	uint16_t actual_bpp = dispi_read(DISPI_INDEX_BPP);
+	uint16_t virtual_width = dispi_read(DISPI_INDEX_VIRT_WIDTH);
+	uint16_t virtual_height = dispi_read(DISPI_INDEX_VIRT_HEIGHT);
+	if(actual_bpp != bpp || virtual_height < actual_height * DISPI_PAGES)
+	{
+		printf("dispi: mode %dx%dx%d was not accepted\n", width, height, bpp);
+		dispi_write(DISPI_INDEX_ENABLE, 0);
+		return false;
+	}
+	visible_height = actual_height;
+
+	memset(format, 0, sizeof(*format));
+	format->base = framebuffer;
+	format->width = actual_width;
+	format->height = actual_height;
+	format->pitch = virtual_width * ((actual_bpp + 7) / 8);
+	format->bpp = actual_bpp;
+	format->pages = DISPI_PAGES;
+	if(actual_bpp == 16)
+	{
+		format->red_position = 11;
+		format->red_size = 5;
+		format->green_position = 5;
+		format->green_size = 6;
+		format->blue_position = 0;
+		format->blue_size = 5;
+	}
+	else if(actual_bpp == 15)
+	{
+		format->red_position = 10;
+		format->red_size = 5;
+		format->green_position = 5;
+		format->green_size = 5;
+		format->blue_position = 0;
+		format->blue_size = 5;
+	}
+	else
+	{
+		format->red_position = 16;
+		format->red_size = 8;
+		format->green_position = 8;
+		format->green_size = 8;
+		format->blue_position = 0;
+		format->blue_size = 8;
+	}
+
+	printf("dispi: interface %x, %dx%dx%d, %d pages, frame buffer at %x\n", id, actual_width, actual_height,
+		actual_bpp, DISPI_PAGES, framebuffer);
+	return true;
+}
+
+//Takes effect with the next frame the adapter scans out
+void dispi_show_page(uint32_t page)
+{
+	dispi_write(DISPI_INDEX_Y_OFFSET, page * visible_height);
+}
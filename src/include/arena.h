@@ -0,0 +1,44 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "stdint.h"
+#include "stdlib.h"
+
+//Default chunk size of the frame arena, 2^2 pages = 16 KB
+#define FRAME_ARENA_ORDER 2
+
+struct arena_chunk;
+
+//Bump allocator over a chain of contiguous chunks from mm_alloc_pages.
+//Nothing is freed individually, the whole arena is rewound at once.
+struct arena
+{
+	const char *name;
+	uint32_t chunk_order;
+	struct arena_chunk *first;
+	struct arena_chunk *current;
+	uint32_t offset;
+
+	//Bytes handed out since the last reset and the maximum of that
+	uint32_t used;
+	uint32_t peak;
+};
+
+//Position inside an arena, everything allocated after it can be released
+struct arena_marker
+{
+	struct arena_chunk *chunk;
+	uint32_t offset;
+	uint32_t used;
+};
+
+//Scratch memory that lives for a single frame of the game loop
+extern struct arena frame_arena;
+
+void arena_init(struct arena *arena, const char *name, uint32_t chunk_order);
+void *arena_alloc(struct arena *arena, size_t size);
+void arena_reset(struct arena *arena);
+struct arena_marker arena_mark(struct arena *arena);
+void arena_release(struct arena *arena, struct arena_marker marker);
+
+#endif
@@ -15,9 +15,21 @@
 #ifndef BIOS_INT_H
 #define BIOS_INT_H
 
+//Low memory scratch buffer for BIOS calls that take a ES:DI pointer
+#define BIOS_BUFFER 0x8000
+
+//General purpose registers are 32 bit wide, the 16 bit names
+//alias the lower halves.
 typedef struct __attribute__ ((packed))
 {
-	unsigned short di, si, bp, sp, bx, dx, cx, ax;
+	union { unsigned int edi; unsigned short di; };
+	union { unsigned int esi; unsigned short si; };
+	union { unsigned int ebp; unsigned short bp; };
+	union { unsigned int esp; unsigned short sp; };
+	union { unsigned int ebx; unsigned short bx; };
+	union { unsigned int edx; unsigned short dx; };
+	union { unsigned int ecx; unsigned short cx; };
+	union { unsigned int eax; unsigned short ax; };
 	unsigned short gs, fs, es, ds, eflags;
 } regs16_t;
 
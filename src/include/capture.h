@@ -0,0 +1,33 @@
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include "stdint.h"
+#include "stdlib.h"
+
+//Frame stream, all numbers little endian:
+//  "SNKF", uint16 width, uint16 height, uint32 frame, uint32 time in us, uint8 flags
+//  768 bytes 8 bit RGB palette if CAPTURE_FLAG_PALETTE is set
+//  RLE codes until width * height delta bytes are decoded
+//The delta is the XOR with the previous frame, key frames use a black one.
+//The time counts from init_capture and wraps after 2^32 us, about 71 minutes.
+#define CAPTURE_MAGIC "SNKF"
+#define CAPTURE_FLAG_KEY     0x01
+#define CAPTURE_FLAG_PALETTE 0x02
+
+//RLE codes
+//  0x00-0x7F  n + 1 literal bytes follow
+//  0x80-0xBF  the next byte repeats (n & 0x3F) + 3 times
+//  0xC0-0xFF  ((n & 0x3F) << 8 | next byte) + 1 unchanged pixels
+#define CAPTURE_LITERAL_MAX 128
+#define CAPTURE_REPEAT_MIN 3
+#define CAPTURE_REPEAT_MAX (0x3F + CAPTURE_REPEAT_MIN)
+#define CAPTURE_SKIP_MAX 0x4000
+
+//A key frame every so many frames lets a decoder join a running stream
+#define CAPTURE_KEY_INTERVAL 64
+
+void init_capture(void);
+bool capture_enabled(void);
+void capture_frame(const uint8_t *buffer, bool palette_changed);
+
+#endif
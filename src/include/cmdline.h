@@ -0,0 +1,12 @@
+#ifndef CMDLINE_H
+#define CMDLINE_H
+
+#include "multiboot.h"
+
+#define CMDLINE_MAX_LENGTH 256
+#define CMDLINE_MAX_ARGS 16
+
+void init_cmdline(struct multiboot_info *mb_info);
+const char *cmdline_get(const char *key);
+
+#endif
@@ -23,4 +23,53 @@ struct cpu_state
     uint32_t   ss;
 };
 
+// Index of the lowest set bit. value must not be zero.
+static inline uint32_t bit_scan_forward(uint32_t value)
+{
+    uint32_t index;
+    __asm__ ("bsf %1, %0" : "=r" (index) : "rm" (value));
+    return index;
+}
+
+// Time stamp counter
+static inline uint64_t rdtsc(void)
+{
+    uint64_t value;
+    __asm__ volatile ("rdtsc" : "=A" (value));
+    return value;
+}
+
+// CPUID leaf 1 EDX feature bits
+#define CPUID_FEAT_EDX_PSE  (1 << 3)
+#define CPUID_FEAT_EDX_PAT  (1 << 16)
+#define CPUID_FEAT_EDX_FXSR (1 << 24)
+#define CPUID_FEAT_EDX_SSE  (1 << 25)
+#define CPUID_FEAT_EDX_SSE2 (1 << 26)
+
+static inline void cpuid(uint32_t leaf, uint32_t *eax, uint32_t *ebx, uint32_t *ecx, uint32_t *edx)
+{
+    __asm__ volatile ("cpuid" : "=a" (*eax), "=b" (*ebx), "=c" (*ecx), "=d" (*edx) : "a" (leaf), "c" (0));
+}
+
+static inline uint64_t rdmsr(uint32_t msr)
+{
+    uint64_t value;
+    __asm__ volatile ("rdmsr" : "=A" (value) : "c" (msr));
+    return value;
+}
+
+static inline void wrmsr(uint32_t msr, uint64_t value)
+{
+    __asm__ volatile ("wrmsr" : : "c" (msr), "A" (value));
+}
+
+// 64 by 32 bit division without libgcc. The quotient has to fit into 32 bit.
+static inline uint32_t div64_32(uint64_t dividend, uint32_t divisor)
+{
+    uint32_t quotient, remainder;
+    __asm__ ("divl %4" : "=a" (quotient), "=d" (remainder)
+        : "a" ((uint32_t)dividend), "d" ((uint32_t)(dividend >> 32)), "rm" (divisor));
+    return quotient;
+}
+
 #endif
@@ -0,0 +1,42 @@
+#ifndef DISPI_H
+#define DISPI_H
+
+#include "stdint.h"
+#include "stdlib.h"
+#include "lfb.h"
+
+//Bochs/QEMU display interface
+#define DISPI_INDEX 0x1CE
+#define DISPI_DATA  0x1CF
+
+#define DISPI_INDEX_ID           0x0
+#define DISPI_INDEX_XRES         0x1
+#define DISPI_INDEX_YRES         0x2
+#define DISPI_INDEX_BPP          0x3
+#define DISPI_INDEX_ENABLE       0x4
+#define DISPI_INDEX_VIRT_WIDTH   0x6
+#define DISPI_INDEX_VIRT_HEIGHT  0x7
+#define DISPI_INDEX_X_OFFSET     0x8
+#define DISPI_INDEX_Y_OFFSET     0x9
+#define DISPI_INDEX_VIDEO_MEMORY 0xA
+
+//Interface versions are 0xB0C0 to 0xB0C5, the video memory register
+//exists since 0xB0C4
+#define DISPI_ID_MASK 0xFFF0
+#define DISPI_ID_BASE 0xB0C0
+#define DISPI_ID_MIN  0xB0C4
+
+#define DISPI_ENABLED     0x01
+#define DISPI_LFB_ENABLED 0x40
+
+//QEMU and Bochs standard VGA
+#define DISPI_PCI_VENDOR 0x1234
+#define DISPI_PCI_DEVICE 0x1111
+
+//Pages stacked in the virtual screen for Y offset flipping
+#define DISPI_PAGES 2
+
+bool dispi_init(uint16_t width, uint16_t height, uint8_t bpp, struct lfb_format *format);
+void dispi_show_page(uint32_t page);
+
+#endif
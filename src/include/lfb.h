@@ -0,0 +1,38 @@
+#ifndef LFB_H
+#define LFB_H
+
+#include "stdint.h"
+#include "stdlib.h"
+
+//Widest supported frame buffer, bounds the row staging buffer
+#define LFB_MAX_WIDTH 2048
+
+//Linear frame buffer as set up by VBE or the boot loader.
+//Color field positions and sizes are only used for direct color (15 to 32 bpp).
+//pages is the number of screens stacked below each other, 0 counts as 1.
+struct lfb_format
+{
+	uintptr_t base;
+	uint32_t width;
+	uint32_t height;
+	uint32_t pitch;
+	uint8_t bpp;
+	uint8_t red_position;
+	uint8_t red_size;
+	uint8_t green_position;
+	uint8_t green_size;
+	uint8_t blue_position;
+	uint8_t blue_size;
+	uint8_t pages;
+};
+
+bool lfb_init(const struct lfb_format *format);
+bool lfb_active(void);
+bool lfb_indexed(void);
+void lfb_set_palette(const uint8_t colors[256][3]);
+uint32_t lfb_get_scale(void);
+void lfb_set_draw_page(uint32_t page);
+void lfb_clear(void);
+void lfb_blit(const uint8_t *buffer, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef MEMOPS_H
+#define MEMOPS_H
+
+#include "stdint.h"
+
+//Copies below this size always take the rep movs/stos path,
+//the SSE2 kernels only pay off once the alignment prologue is amortised
+#define MEMOPS_SMALL_SIZE 256
+
+//Size of the boot benchmark buffers, one mode 13h frame
+#define MEMOPS_BENCHMARK_SIZE 64000
+#define MEMOPS_BENCHMARK_ROUNDS 16
+
+void init_memops(void);
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef MEMTRACK_H
+#define MEMTRACK_H
+
+#include "stdint.h"
+
+#define MEMTRACK_STR2(x) #x
+#define MEMTRACK_STR(x) MEMTRACK_STR2(x)
+//Tag of the calling source line, e.g. "./snake.c:42"
+#define MM_SITE __FILE__ ":" MEMTRACK_STR(__LINE__)
+
+//Distinct allocation sites and live allocations that can be tracked
+#define MEMTRACK_MAX_SITES 32
+#define MEMTRACK_MAX_LIVE 2048
+//Distinct report names that keep a snapshot to compare against
+#define MEMTRACK_MAX_REPORTS 4
+
+void memtrack_alloc(const void *ptr, uint32_t size, const char *site);
+void memtrack_free(const void *ptr);
+void memtrack_report(const char *name);
+
+#endif
@@ -1,10 +1,50 @@
 #ifndef MM_H
 #define MM_H
 
+//Check the page allocator against a linear bitmap scan at boot
+#define MM_SELFTEST
+
+#include "stdint.h"
+#include "stdlib.h"
 #include "multiboot.h"
+#include "memtrack.h"
+
+#define PAGE_SIZE 4096
+//Largest block of the buddy allocator, 2^8 pages = 1 MB
+#define MM_MAX_ORDER 8
+//Frames kept cleared for mm_alloc_zeroed
+#define ZERO_POOL_SIZE 64
+
+struct mm_stats
+{
+	uint32_t total_frames;
+	uint32_t used_frames;
+	uint32_t free_frames;
+	uint32_t peak_used_frames;
+
+	uint32_t zero_pool_frames;
+	uint32_t zero_pool_hits;
+	uint32_t zero_pool_misses;
+};
+
+//Allocations are tagged with the calling source line for leak reports
+#define mm_alloc() mm_alloc_site(MM_SITE)
+#define mm_alloc_zeroed() mm_alloc_zeroed_site(MM_SITE)
+#define mm_alloc_pages(order) mm_alloc_pages_site((order), MM_SITE)
 
 void init_mm(struct multiboot_info *mb_info);
-void* mm_alloc();
+void* mm_alloc_site(const char *site);
+void* mm_alloc_zeroed_site(const char *site);
+bool mm_zero_pool_refill(void);
 void mm_free(void* addr);
 void mm_mark_used(void * addr);
+void mm_free_range(uint64_t start, uint64_t end);
+void mm_mark_used_range(uint64_t start, uint64_t end);
+
+//Physically contiguous blocks of 2^order pages
+uint32_t mm_size_to_order(size_t size);
+void* mm_alloc_pages_site(uint32_t order, const char *site);
+void mm_free_pages(void* addr, uint32_t order);
+void mm_print_buddy_stats(void);
+void mm_get_stats(struct mm_stats *stats);
 #endif
@@ -0,0 +1,41 @@
+#ifndef MODEX_H
+#define MODEX_H
+
+#include "stdint.h"
+#include "stdlib.h"
+#include "sprite.h"
+
+//Unchained 320x240x256, four pixels share one address, one per plane
+#define MODEX_WIDTH 320
+#define MODEX_HEIGHT 240
+#define MODEX_PITCH (MODEX_WIDTH / 4)
+#define MODEX_PAGE_SIZE (MODEX_PITCH * MODEX_HEIGHT)
+
+//Pages are flipped through the CRTC start address, the VRAM behind
+//them keeps static images for latch copies
+#define MODEX_PAGES 2
+#define MODEX_VRAM_SIZE 0x10000
+#define MODEX_STATIC_OFFSET (MODEX_PAGES * MODEX_PAGE_SIZE)
+
+//Image in off-screen VRAM, width is a multiple of 4
+struct modex_image
+{
+	uint16_t width;
+	uint16_t height;
+	uint16_t offset;
+};
+
+//All drawing goes to the hidden page, modex_flip shows it.
+//The m13hb_* functions must not be used while Mode X is active.
+void modex_init(void);
+void modex_clear(uint8_t color);
+void modex_set_pixel(uint16_t x, uint16_t y, uint8_t color);
+void modex_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t color);
+void modex_draw_sprite(const struct sprite *sprite, int16_t x, int16_t y);
+void modex_puts(uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, const char *s);
+bool modex_store_sprite(struct modex_image *image, const struct sprite *sprite, uint8_t bg_color);
+void modex_blit_image(const struct modex_image *image, uint16_t x, uint16_t y);
+void modex_copy_visible(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+void modex_flip(void);
+
+#endif
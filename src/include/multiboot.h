@@ -43,6 +43,15 @@ struct multiboot_elf_section_header_table
 };
 typedef struct multiboot_elf_section_header_table multiboot_elf_section_header_table_t;
 
+/* Flags of multiboot_info, a set flag means the fields are valid */
+#define MULTIBOOT_INFO_MEMORY                   0x00000001
+#define MULTIBOOT_INFO_BOOTDEV                  0x00000002
+#define MULTIBOOT_INFO_CMDLINE                  0x00000004
+#define MULTIBOOT_INFO_MODS                     0x00000008
+#define MULTIBOOT_INFO_MEM_MAP                  0x00000040
+#define MULTIBOOT_INFO_VBE_INFO                 0x00000800
+#define MULTIBOOT_INFO_FRAMEBUFFER_INFO         0x00001000
+
 struct multiboot_info
 {
 		/* Multiboot info version number */
@@ -0,0 +1,12 @@
+#ifndef PAGING_H
+#define PAGING_H
+
+#include "stdint.h"
+#include "stdlib.h"
+
+void init_paging(void);
+bool paging_enabled(void);
+bool paging_write_combining_supported(void);
+void paging_set_write_combining(uintptr_t addr, size_t size, bool enable);
+
+#endif
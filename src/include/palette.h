@@ -0,0 +1,36 @@
+#ifndef PALETTE_H
+#define PALETTE_H
+
+#include "stdint.h"
+#include "stdlib.h"
+
+#define PALETTE_SIZE 256
+#define PALETTE_MAX_CYCLES 4
+
+//Fade levels, 0 shows the saved palette, PALETTE_FADE_FULL only the fade color
+#define PALETTE_FADE_FULL 256
+
+//Colors are 8 bit RGB like vga_palette.
+//The saved palette is what the game draws with. The active palette is the
+//saved one with color cycles and the fade applied, it is what the DAC shows.
+//All times are PIT ticks.
+void init_palette(void);
+void palette_set(uint8_t index, uint8_t red, uint8_t green, uint8_t blue);
+void palette_load(const uint8_t colors[PALETTE_SIZE][3]);
+//768 bytes, three per entry
+const uint8_t *palette_get_active(void);
+const uint8_t *palette_get_saved(void);
+
+void palette_fade_out(uint8_t red, uint8_t green, uint8_t blue, uint32_t now, uint32_t duration);
+void palette_fade_in(uint32_t now, uint32_t duration);
+void palette_flash(uint8_t red, uint8_t green, uint8_t blue, uint32_t now, uint32_t duration);
+bool palette_fading(void);
+
+bool palette_add_cycle(uint8_t first, uint8_t count, uint32_t period, uint32_t now);
+void palette_clear_cycles(void);
+
+void palette_update(uint32_t now);
+bool palette_pending(void);
+bool palette_flush(void);
+
+#endif
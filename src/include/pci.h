@@ -0,0 +1,44 @@
+#ifndef PCI_H
+#define PCI_H
+
+#include "stdint.h"
+#include "stdlib.h"
+
+//Configuration mechanism 1
+#define PCI_CONFIG_ADDRESS 0xCF8
+#define PCI_CONFIG_DATA    0xCFC
+
+#define PCI_MAX_DEVICES 32
+
+//Configuration space offsets
+#define PCI_VENDOR_ID   0x00
+#define PCI_DEVICE_ID   0x02
+#define PCI_COMMAND     0x04
+#define PCI_CLASS       0x08
+#define PCI_HEADER_TYPE 0x0E
+#define PCI_BAR0        0x10
+
+#define PCI_COMMAND_MEMORY 0x0002
+#define PCI_HEADER_MULTI_FUNCTION 0x80
+#define PCI_BAR_IO 0x01
+#define PCI_NO_DEVICE 0xFFFF
+
+struct pci_device
+{
+	uint8_t bus;
+	uint8_t slot;
+	uint8_t function;
+	uint16_t vendor_id;
+	uint16_t device_id;
+	uint8_t class_code;
+	uint8_t subclass;
+};
+
+void init_pci(void);
+uint32_t pci_read32(const struct pci_device *device, uint8_t offset);
+uint16_t pci_read16(const struct pci_device *device, uint8_t offset);
+void pci_write32(const struct pci_device *device, uint8_t offset, uint32_t value);
+const struct pci_device *pci_find_device(uint16_t vendor_id, uint16_t device_id);
+uintptr_t pci_memory_bar(const struct pci_device *device, uint8_t bar);
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "stdint.h"
+#include "stdlib.h"
+
+#define PROFILE_MAX_STAGES 8
+//Stage 0 is the whole frame from profile_frame_begin to profile_frame_end
+#define PROFILE_FRAME 0
+#define PROFILE_NAME_LENGTH 10
+
+//Samples kept per stage for the 99th percentile
+#define PROFILE_HISTORY 256
+//Frames per CSV block sent over COM1 and per overlay update
+#define PROFILE_CSV_INTERVAL 64
+#define PROFILE_OVERLAY_INTERVAL 16
+
+void init_profile(void);
+uint8_t profile_add_stage(const char *name);
+void profile_reset(void);
+
+//Cycles from begin to end are added to the stage, a stage may run several times per frame
+void profile_begin(uint8_t stage);
+void profile_end(uint8_t stage);
+
+void profile_frame_begin(void);
+void profile_frame_end(uint32_t snake_length);
+
+bool profile_overlay_enabled(void);
+void profile_draw_overlay(uint16_t x, uint16_t y);
+void profile_print_stats(void);
+
+//Times the rest of the enclosing block
+static inline uint8_t profile_scope_begin(uint8_t stage)
+{
+	profile_begin(stage);
+	return stage;
+}
+
+static inline void profile_scope_end(uint8_t *stage)
+{
+	profile_end(*stage);
+}
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage) uint8_t PROFILE_CONCAT(profile_scope_, __LINE__) \
+	__attribute__((cleanup(profile_scope_end))) = profile_scope_begin(stage)
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include "stdint.h"
+#include "stdlib.h"
+#include "sprite.h"
+
+//Coordinates are pixels of the 320x200 mode 13h screen, tiles are cells
+//of the tile map and colors are palette indices. Text backends round to
+//their character cells and leave out what has no character equivalent.
+#define RENDERER_WIDTH 320
+#define RENDERER_HEIGHT 200
+
+//Longest line renderer_printf formats
+#define RENDERER_FORMAT_LENGTH 64
+
+//Backends drawing at the same time, the selected one and the serial terminal
+#define RENDERER_MAX_TARGETS 2
+
+struct renderer
+{
+	const char *name;
+	bool (*init)(void);
+	void (*clear)(void);
+	void (*fill_rect)(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color);
+	void (*draw_frame)(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color);
+	void (*blit_tile)(uint16_t x, uint16_t y, uint8_t tile);
+	void (*draw_sprite)(const struct sprite *sprite, int16_t x, int16_t y);
+	void (*draw_text)(int16_t x, int16_t y, uint8_t color, const char *text);
+	void (*present)(void);
+};
+
+//How a tile looks, as a sprite or as a character
+struct renderer_tile
+{
+	struct sprite *sprite;
+	char glyph;
+	uint8_t color;
+};
+
+extern const struct renderer renderer_m13h;
+extern const struct renderer renderer_modex;
+extern const struct renderer renderer_text;
+extern const struct renderer renderer_null;
+extern const struct renderer renderer_ansi;
+
+void init_renderer(void);
+const char *renderer_get_name(void);
+
+void renderer_set_tile(uint8_t tile, struct sprite *sprite, char glyph, uint8_t color);
+const struct renderer_tile *renderer_get_tile(uint8_t tile);
+//Closest of the 16 text mode colors to a palette entry
+uint8_t renderer_text_color(uint8_t color);
+
+void renderer_clear(void);
+void renderer_fill_rect(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color);
+void renderer_hline(int16_t x, int16_t y, uint16_t length, uint8_t color);
+void renderer_draw_frame(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color);
+void renderer_blit_tile(uint16_t x, uint16_t y, uint8_t tile);
+void renderer_draw_sprite(const struct sprite *sprite, int16_t x, int16_t y);
+int renderer_printf(int16_t x, int16_t y, uint8_t color, const char *fmt, ...);
+void renderer_present(void);
+
+#endif
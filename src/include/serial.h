@@ -6,10 +6,21 @@
 #define COM3 0x3E8
 #define COM4 0x2E8
 
+#include "stdint.h"
+
+//Divisors of the 115200 baud base clock
+#define SERIAL_DIVISOR_115200 1
+#define SERIAL_DIVISOR_38400 3
+
 void init_serial();
+void init_serial_port(uint16_t port, uint16_t divisor);
+void serial_enable_receive_irq(uint16_t port);
 int serial_received();
+int serial_received_port(uint16_t port);
 char read_serial();
+char read_serial_port(uint16_t port);
 int is_transmit_empty();
 void write_serial(char a);
+void write_serial_port(uint16_t port, char a);
 
 #endif
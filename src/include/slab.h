@@ -0,0 +1,46 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include "stdint.h"
+#include "stdlib.h"
+#include "memtrack.h"
+
+#define KMEM_MAX_CACHES 16
+//Smallest and largest kmalloc size class, every class is a power of two
+#define KMALLOC_MIN_SIZE 8
+#define KMALLOC_MAX_SIZE 2048
+
+struct slab;
+
+//Object cache. Objects of one size are packed into pages taken from mm_alloc.
+struct kmem_cache
+{
+	const char *name;
+	uint32_t object_size;
+	uint32_t objects_per_slab;
+	uint32_t first_object;
+
+	struct slab *partial;
+	struct slab *full;
+	struct slab *empty;
+
+	uint32_t slab_count;
+	uint32_t objects_in_use;
+};
+
+//Allocations are tagged with the calling source line for leak reports
+#define kmem_cache_alloc(cache) kmem_cache_alloc_site((cache), MM_SITE)
+#define kmalloc(size) kmalloc_site((size), MM_SITE)
+
+void init_slab(void);
+
+struct kmem_cache *kmem_cache_create(const char *name, uint32_t object_size);
+void *kmem_cache_alloc_site(struct kmem_cache *cache, const char *site);
+void kmem_cache_free(struct kmem_cache *cache, void *object);
+
+void *kmalloc_site(size_t size, const char *site);
+void kfree(void *object);
+
+void kmem_print_stats(void);
+
+#endif
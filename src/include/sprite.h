@@ -0,0 +1,50 @@
+#ifndef SPRITE_H
+#define SPRITE_H
+
+#include "stdint.h"
+#include "arena.h"
+
+//Palette index that is left out of compiled sprites
+#define SPRITE_TRANSPARENT 36
+
+//Chunk size of the arena holding compiled sprites, 2^1 pages = 8 KB
+#define SPRITE_ARENA_ORDER 1
+
+//Orientations for sprite_compile_oriented, applied to the image as it is
+//shown. Transposing swaps rows and columns and comes before the flips.
+#define SPRITE_NORMAL     0
+#define SPRITE_FLIP_X     1
+#define SPRITE_FLIP_Y     2
+#define SPRITE_TRANSPOSE  4
+#define SPRITE_ORIENTATIONS 8
+
+//Clockwise rotations
+#define SPRITE_ROTATE_90  (SPRITE_TRANSPOSE | SPRITE_FLIP_X)
+#define SPRITE_ROTATE_180 (SPRITE_FLIP_X | SPRITE_FLIP_Y)
+#define SPRITE_ROTATE_270 (SPRITE_TRANSPOSE | SPRITE_FLIP_Y)
+
+//Run of opaque pixels inside a sprite row
+struct sprite_span
+{
+	uint16_t x;
+	uint16_t length;
+	//Index of the first pixel in sprite->pixels
+	uint16_t offset;
+};
+
+//Sprite converted into opaque runs, rows are stored top-down.
+//Row i spans from spans[rows[i]] up to spans[rows[i + 1]].
+struct sprite
+{
+	uint16_t width;
+	uint16_t height;
+	uint16_t *rows;
+	struct sprite_span *spans;
+	uint8_t *pixels;
+};
+
+struct sprite *sprite_compile(struct arena *arena, const uint8_t *img, uint16_t width, uint16_t height);
+//Width and height are those of the bitmap, rotating by 90 or 270 degrees swaps them
+struct sprite *sprite_compile_oriented(struct arena *arena, const uint8_t *img, uint16_t width, uint16_t height, uint8_t orientation);
+
+#endif
@@ -7,19 +7,29 @@
 
 #include "stdlib.h"
 #include "stdint.h"
+#include "stdarg.h"
 
 void cls(void);
+void set_serial_output(bool enabled);
+void set_console_output(bool enabled);
 void putc(char c);
 void puts(const char* s);
 
 int printf(const char* fmt, ...);
+int vsnprintf(char *text, size_t size, const char *fmt, va_list ap);
 
 void *memset(void *b, int c, int len);
 void memcpy(void * destination, const void * source, size_t num);
+int memcmp(const void *a, const void *b, size_t length);
+size_t strlen(const char *s);
+int strcmp(const char *a, const char *b);
+int strncmp(const char *a, const char *b, size_t length);
 
 uint8_t inportb(uint16_t _port);
 void outportb(uint16_t _port, uint8_t _data);
 uint16_t inport(uint16_t _port);
 void outport(uint16_t _port, uint16_t _data);
+uint32_t inportl(uint16_t _port);
+void outportl(uint16_t _port, uint32_t _data);
 
 #endif
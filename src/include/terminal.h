@@ -0,0 +1,47 @@
+#ifndef TERMINAL_H
+#define TERMINAL_H
+
+#include "stdint.h"
+#include "stdlib.h"
+
+//Same grid as the tile map, one character per 8x8 cell
+#define TERMINAL_WIDTH 40
+#define TERMINAL_HEIGHT 25
+
+//ANSI colors, TERMINAL_BRIGHT selects the bold variant
+#define TERMINAL_BLACK   0
+#define TERMINAL_RED     1
+#define TERMINAL_GREEN   2
+#define TERMINAL_YELLOW  3
+#define TERMINAL_BLUE    4
+#define TERMINAL_MAGENTA 5
+#define TERMINAL_CYAN    6
+#define TERMINAL_WHITE   7
+#define TERMINAL_BRIGHT  8
+
+//Longest line terminal_printf formats
+#define TERMINAL_FORMAT_LENGTH (TERMINAL_WIDTH + 1)
+
+//Scancodes handed to on_key for keys typed into the terminal
+#define TERMINAL_SCANCODE_UP    0x48
+#define TERMINAL_SCANCODE_DOWN  0x50
+#define TERMINAL_SCANCODE_LEFT  0x4B
+#define TERMINAL_SCANCODE_RIGHT 0x4D
+#define TERMINAL_SCANCODE_ENTER 0x1C
+#define TERMINAL_SCANCODE_SPACE 0x39
+
+void init_terminal(void);
+bool terminal_active(void);
+
+//Drawing only changes the cell buffer, terminal_present sends the changes
+void terminal_clear(void);
+void terminal_put(uint16_t x, uint16_t y, char c, uint8_t color);
+void terminal_hline(uint16_t x, uint16_t y, uint16_t w, char c, uint8_t color);
+void terminal_draw_frame(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t color);
+int terminal_printf(uint16_t x, uint16_t y, uint8_t color, const char *fmt, ...);
+uint32_t terminal_present(void);
+
+//Next key received from the terminal as a scancode, 0 if there is none
+uint8_t terminal_read_key(void);
+
+#endif
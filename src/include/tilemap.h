@@ -0,0 +1,20 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include "stdint.h"
+
+//The 320x200 screen as a grid of 8x8 cells
+#define TILEMAP_WIDTH 40
+#define TILEMAP_HEIGHT 25
+#define TILE_SIZE 8
+
+#define TILEMAP_MAX_TILES 16
+//Tile id 0 is an empty cell, cleared to background color 0
+#define TILE_EMPTY 0
+
+void tilemap_reset(void);
+void tilemap_set(uint16_t x, uint16_t y, uint8_t tile);
+uint8_t tilemap_get(uint16_t x, uint16_t y);
+uint32_t tilemap_draw(void);
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef TSC_H
+#define TSC_H
+
+#include "stdint.h"
+
+void init_tsc(void);
+uint32_t tsc_get_khz(void);
+uint32_t tsc_cycles_to_us(uint64_t cycles);
+uint32_t tsc_mb_per_s(uint64_t bytes, uint64_t cycles);
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef VBE_H
+#define VBE_H
+
+#include "stdint.h"
+#include "stdlib.h"
+
+//Returned in AX by every successful VBE call
+#define VBE_SUCCESS 0x004F
+
+//Mode attributes
+#define VBE_MODE_SUPPORTED 0x0001
+#define VBE_MODE_GRAPHICS  0x0010
+#define VBE_MODE_LFB       0x0080
+
+//Memory models
+#define VBE_MEMORY_PACKED  4
+#define VBE_MEMORY_DIRECT  6
+
+//Set mode flag for the linear frame buffer
+#define VBE_SET_MODE_LFB   0x4000
+
+#define VBE_MAX_MODES 128
+
+//Function 0x4F00
+struct vbe_controller_info
+{
+	char signature[4];
+	uint16_t version;
+	uint32_t oem_string;
+	uint32_t capabilities;
+	uint32_t video_modes;
+	uint16_t total_memory;
+	uint16_t software_revision;
+	uint32_t vendor;
+	uint32_t product_name;
+	uint32_t product_revision;
+	uint8_t reserved[222];
+	uint8_t oem_data[256];
+} __attribute__((packed));
+
+//Function 0x4F01
+struct vbe_mode_info
+{
+	uint16_t attributes;
+	uint8_t window_a;
+	uint8_t window_b;
+	uint16_t granularity;
+	uint16_t window_size;
+	uint16_t segment_a;
+	uint16_t segment_b;
+	uint32_t window_function;
+	uint16_t pitch;
+	uint16_t width;
+	uint16_t height;
+	uint8_t char_width;
+	uint8_t char_height;
+	uint8_t planes;
+	uint8_t bpp;
+	uint8_t banks;
+	uint8_t memory_model;
+	uint8_t bank_size;
+	uint8_t image_pages;
+	uint8_t reserved0;
+	uint8_t red_mask_size;
+	uint8_t red_position;
+	uint8_t green_mask_size;
+	uint8_t green_position;
+	uint8_t blue_mask_size;
+	uint8_t blue_position;
+	uint8_t reserved_mask_size;
+	uint8_t reserved_position;
+	uint8_t direct_color_attributes;
+	uint32_t framebuffer;
+	uint32_t off_screen_memory;
+	uint16_t off_screen_size;
+	uint8_t reserved1[206];
+} __attribute__((packed));
+
+//A mode usable through the linear frame buffer
+struct vbe_mode
+{
+	uint16_t number;
+	uint16_t width;
+	uint16_t height;
+	uint16_t pitch;
+	uint8_t bpp;
+	uint32_t framebuffer;
+	uint8_t red_position;
+	uint8_t red_size;
+	uint8_t green_position;
+	uint8_t green_size;
+	uint8_t blue_position;
+	uint8_t blue_size;
+};
+
+bool vbe_find_mode(uint16_t width, uint16_t height, uint8_t bpp, struct vbe_mode *mode);
+bool vbe_set_mode(const struct vbe_mode *mode);
+
+#endif
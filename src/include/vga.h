@@ -0,0 +1,34 @@
+#ifndef VGA_H
+#define VGA_H
+
+//VGA register ports
+#define VGA_MISC_OUTPUT     0x3C2
+#define VGA_SC_INDEX        0x3C4
+#define VGA_SC_DATA         0x3C5
+#define VGA_DAC_WRITE_INDEX 0x3C8
+#define VGA_DAC_DATA        0x3C9
+#define VGA_GC_INDEX        0x3CE
+#define VGA_GC_DATA         0x3CF
+#define VGA_CRTC_INDEX      0x3D4
+#define VGA_CRTC_DATA       0x3D5
+#define VGA_INPUT_STATUS    0x3DA
+
+//Input status register 1
+#define VGA_DISPLAY_DISABLED 0x01
+#define VGA_RETRACE          0x08
+
+//Sequencer registers
+#define VGA_SC_RESET        0x00
+#define VGA_SC_MAP_MASK     0x02
+#define VGA_SC_MEMORY_MODE  0x04
+
+//Graphics controller registers
+#define VGA_GC_MODE         0x05
+#define VGA_GC_BIT_MASK     0x08
+
+//CRT controller registers
+#define VGA_CRTC_START_HIGH 0x0C
+#define VGA_CRTC_START_LOW  0x0D
+#define VGA_CRTC_V_RETRACE_END 0x11
+
+#endif
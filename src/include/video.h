@@ -3,25 +3,80 @@
 
 #include "stdarg.h"
 #include "stdint.h"
+#include "stdlib.h"
 #include "stdarg.h"
+#include "multiboot.h"
 
 #define MODE_13H_MEMORY 0xA0000
 #define SCREEN_WIDTH 320
 #define SCREEN_HEIGHT 200
 
+//Screen rectangle, x1 and y1 are exclusive
+struct m13h_rect
+{
+	uint16_t x0;
+	uint16_t y0;
+	uint16_t x1;
+	uint16_t y1;
+};
+
+struct sprite;
+
+struct m13h_present_stats
+{
+	uint32_t frames;
+	uint32_t last_frame_bytes;
+	uint64_t total_bytes;
+
+	//Time spent copying to VGA memory and waiting for the retrace, in TSC cycles
+	uint32_t last_copy_cycles;
+	uint32_t max_copy_cycles;
+	uint64_t total_copy_cycles;
+	uint64_t total_wait_cycles;
+	uint64_t first_present_tsc;
+	uint64_t last_present_tsc;
+
+	//Presents that did not fit into the blanking interval or found no retrace
+	uint32_t missed_retraces;
+	//Measured display refresh rate in 1/100 Hz, 0 if unknown
+	uint32_t refresh_centihz;
+};
+
 void m13hb_draw_buffer(uint8_t *buffer, uint64_t size);
+uint32_t m13hb_present(uint8_t *buffer);
+void m13hb_get_present_stats(struct m13h_present_stats *stats);
+void m13hb_print_present_stats(void);
+void m13hb_init_vsync(void);
+void m13hb_set_vsync(bool enabled);
+void m13hb_invalidate(void);
 void m13hb_cls(uint8_t *buffer);
-void m13hb_set_pixel(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color);
-void m13hb_draw_bmp(uint8_t *buffer, uint8_t *img, uint16_t width, uint16_t height, uint16_t x, uint16_t y);
-void m13hb_draw_transparent_bitmap(uint8_t *buffer, uint8_t *img, uint16_t width, uint16_t height, uint16_t x, uint16_t y);
-void m13hb_line(uint8_t *buffer, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t color);
+
+//Drawing is clipped against the clip rectangle, the whole screen by default
+void m13hb_set_clip(int16_t x, int16_t y, uint16_t width, uint16_t height);
+void m13hb_reset_clip(void);
+void m13hb_set_pixel(uint8_t *buffer, int16_t x, int16_t y, uint8_t color);
+void m13hb_draw_rect(uint8_t *buffer, int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color);
+void m13hb_hline(uint8_t *buffer, int16_t x, int16_t y, uint16_t length, uint8_t color);
+void m13hb_vline(uint8_t *buffer, int16_t x, int16_t y, uint16_t length, uint8_t color);
+void m13hb_draw_frame(uint8_t *buffer, int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color);
+void m13hb_line(uint8_t *buffer, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color);
+void m13hb_circle(uint8_t *buffer, int16_t cx, int16_t cy, uint16_t radius, uint8_t color);
+void m13hb_fill_circle(uint8_t *buffer, int16_t cx, int16_t cy, uint16_t radius, uint8_t color);
+void m13hb_draw_bmp(uint8_t *buffer, uint8_t *img, uint16_t width, uint16_t height, int16_t x, int16_t y);
+void m13hb_draw_transparent_bitmap(uint8_t *buffer, uint8_t *img, uint16_t width, uint16_t height, int16_t x, int16_t y);
+void m13hb_draw_sprite(uint8_t *buffer, const struct sprite *sprite, int16_t x, int16_t y);
+
 void m13hb_print_8x8_character(uint8_t *buffer, uint8_t *character, uint16_t x, uint16_t y, uint8_t color);
 void m13hb_print_8x8_character_background(uint8_t *buffer, uint8_t *character, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color);
 void m13hb_putc(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, char c);
 void m13hb_puts(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, const char* s);
 void m13hb_putn(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, unsigned long value, int base);
 int m13hb_printf(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, const char* fmt, ...);
-void m13hb_draw_rect(uint8_t *buffer, uint16_t x, uint16_t y, uint16_t width, uint16_t heigth, uint8_t color);
+void m13hb_benchmark_present(uint8_t *buffer);
 
 void mode_13h_cls();
+void vga_load_default_palette(void);
+void init_boot_framebuffer(struct multiboot_info *mb_info);
+void init_video(void);
+bool video_text_mode_available(void);
 #endif
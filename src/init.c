@@ -2,7 +2,17 @@
 #include "serial.h"
 #include "interrupt.h"
 #include "multiboot.h"
+#include "cmdline.h"
+#include "video.h"
 #include "mm.h"
+#include "slab.h"
+#include "tsc.h"
+#include "paging.h"
+#include "memops.h"
+#include "pci.h"
+#include "capture.h"
+#include "terminal.h"
+#include "profile.h"
 #include "snake.h"
 
 void init(struct multiboot_info *mb_info)
@@ -22,12 +32,45 @@ void init(struct multiboot_info *mb_info)
 	printf("/   ~\\ \n");
 	printf("---------------------------------------------------------------------------\n");
 
+	//Keep a copy of the kernel command line before memory gets reused
+	init_cmdline(mb_info);
+
+	//The boot loader may already have set a graphics mode for us
+	init_boot_framebuffer(mb_info);
+
+	//Setup Global Descriptor Table
+	init_gdt();
+
+	//Setup Interrupts
+	//This has to happen before any BIOS call, int32 enables interrupts on return
+	init_intr();
+
+	//Calibrate the time stamp counter against the PIT
+	init_tsc();
+
 	//Initialise physical memory management
 	//Physical memory is split into pages of 4096 Bytes.
-	//At the moment if we need to allocate memory in the game we always allocate
-	//pages of 4096 Bytes.
-	//@TODO Implement propper memory management
+	//Small objects are packed into pages by the slab allocator.
 	init_mm(mb_info);
+	init_slab();
+
+	//Identity map memory, the VGA aperture becomes write-combining
+	init_paging();
+
+	//Pick the fastest memcpy/memset for this CPU
+	init_memops();
+
+	//Enumerate PCI devices for the display drivers
+	init_pci();
+
+	//Stream presented frames over a serial port if capture= is set
+	init_capture();
+
+	//Draw the game on a serial terminal as well if terminal= is set
+	init_terminal();
+
+	//Frame time stages, profile= turns on the overlay and the CSV output
+	init_profile();
 
 	//Setup keyboard
 	//Clear keyboard buffer
@@ -40,12 +83,6 @@ void init(struct multiboot_info *mb_info)
 	while ((inportb(0x64) & 0x2)) {}
 	outportb(0x60, 0xF4);
 
-	//Setup Global Descriptor Table
-	init_gdt();
-
-	//Setup Interrupts
-	init_intr();
-
 	//Start snake game
 	snake_init();
 
@@ -11,8 +11,11 @@
 ; License: http://creativecommons.org/licenses/by-sa/2.0/uk/
 ;         
 ; Notes: This file is in NASM syntax.
-;        Turn off paging before calling these functions.
+;        Paging is turned off during the call and restored afterwards,
+;        the code and data below 1MB have to be identity mapped.
 ;        int32() resets all selectors.
+;        The general purpose registers are passed as 32bit values so
+;        BIOS functions like INT 0x15, EAX = 0xE820 can be used.
 ;
 ; C Prototype:
 ;	void _cdelc int32(unsigned char intnum, regs16_t *regs);
@@ -33,14 +36,14 @@
 global int32, _int32
 
 struc regs16_t
-	.di	resw 1
-	.si	resw 1
-	.bp	resw 1
-	.sp resw 1
-	.bx	resw 1
-	.dx	resw 1
-	.cx	resw 1
-	.ax	resw 1
+	.di	resd 1
+	.si	resd 1
+	.bp	resd 1
+	.sp resd 1
+	.bx	resd 1
+	.dx	resd 1
+	.cx	resd 1
+	.ax	resd 1
 	.gs	resw 1
 	.fs	resw 1
 	.es	resw 1
@@ -76,6 +79,10 @@ section .text
 		rep  movsb                             ; do the actual copy (relocate code to low 16bit space)
 		jmp INT32_BASE                         ; jump to new code location
 	reloc: use32                               ; by Napalm
+		mov  eax, cr0                          ; get cr0 so we can turn off paging
+		mov  [REBASE(cr0_32)], eax             ; save 32bit cr0 (PG may be set)
+		and  eax, 0x7FFFFFFF                   ; mask off PG, the low memory is identity mapped
+		mov  cr0, eax                          ; set cr0 to result
 		mov  [REBASE(stack32_ptr)], esp        ; save 32bit stack pointer
 		sidt [REBASE(idt32_ptr)]               ; save 32bit idt pointer
 		sgdt [REBASE(gdt32_ptr)]               ; save 32bit gdt pointer
@@ -107,7 +114,7 @@ section .text
 		lidt [REBASE(idt16_ptr)]               ; load 16bit idt
 		mov  bx, 0x0870                        ; master 8 and slave 112
 		call resetpic                          ; set pic's the to real-mode settings
-		popa                                   ; load general purpose registers from 16bit stack
+		popad                                  ; load 32bit general purpose registers from 16bit stack
 		pop  gs                                ; load gs from 16bit stack
 		pop  fs                                ; load fs from 16bit stack
 		pop  es                                ; load es from 16bit stack
@@ -124,7 +131,7 @@ section .text
 		push es                                ; save es to 16bit stack
 		push fs                                ; save fs to 16bit stack
 		push gs                                ; save gs to 16bit stack
-		pusha                                  ; save general purpose registers to 16bit stack
+		pushad                                 ; save 32bit general purpose registers to 16bit stack
 		mov  bx, 0x2028                        ; master 32 and slave 40
 		call resetpic                          ; restore the pic's to protected mode settings
 		mov  eax, cr0                          ; get cr0 so we can modify it
@@ -140,6 +147,8 @@ section .text
 		mov  ss, ax                            ; reset ss selector
 		lgdt [REBASE(gdt32_ptr)]               ; restore 32bit gdt pointer
 		lidt [REBASE(idt32_ptr)]               ; restore 32bit idt pointer
+		mov  eax, [REBASE(cr0_32)]             ; get saved 32bit cr0
+		mov  cr0, eax                          ; turn paging back on if it was enabled
 		mov  esp, [REBASE(stack32_ptr)]        ; restore 32bit stack pointer
 		mov  esi, STACK16                      ; set copy source to 16bit stack
 		lea  edi, [esp+0x28]                   ; set position of regs pointer on 32bit stack
@@ -170,6 +179,9 @@ section .text
 		pop  ax                                ; restore ax from stack
 		ret                                    ; return to caller
 		
+	cr0_32:                                    ; cr0 of the caller, restored
+		dd 0x00000000                          ;   after returning to protected mode
+
 	stack32_ptr:                               ; address in 32bit stack after we
 		dd 0x00000000                          ;   save all general purpose registers
 		
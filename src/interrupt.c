@@ -8,6 +8,7 @@
 #include "stdio.h"
 #include "snake.h"
 #include "bios_int.h"
+#include "terminal.h"
 
 extern void intr_stub_0(void);
 extern void intr_stub_1(void);
@@ -31,6 +32,8 @@ extern void intr_stub_18(void);
 
 extern void intr_stub_32(void);
 extern void intr_stub_33(void);
+extern void intr_stub_35(void);
+extern void intr_stub_36(void);
 
 //GDT and IDT
 static uint64_t gdt[GDT_ENTRIES];
@@ -171,6 +174,8 @@ void init_intr(void)
     // IRQs
     idt_set_entry(32, intr_stub_32, 0x8, IDT_FLAG_INTERRUPT_GATE | IDT_FLAG_RING0 | IDT_FLAG_PRESENT);
     idt_set_entry(33, intr_stub_33, 0x8, IDT_FLAG_INTERRUPT_GATE | IDT_FLAG_RING0 | IDT_FLAG_PRESENT);
+    idt_set_entry(35, intr_stub_35, 0x8, IDT_FLAG_INTERRUPT_GATE | IDT_FLAG_RING0 | IDT_FLAG_PRESENT);
+    idt_set_entry(36, intr_stub_36, 0x8, IDT_FLAG_INTERRUPT_GATE | IDT_FLAG_RING0 | IDT_FLAG_PRESENT);
 
     __asm__ volatile("lidt %0" : : "m" (idtp));
 
@@ -184,6 +189,8 @@ struct cpu_state* handle_interrupt(struct cpu_state* cpu)
 
 	if (cpu->intr <= 0x1f)
 	{
+		//The text mode renderer may have turned the console off
+		set_console_output(true);
 		cls();
     printf("Exception %d, kernel stopped!\n", cpu->intr);
 
@@ -233,6 +240,14 @@ struct cpu_state* handle_interrupt(struct cpu_state* cpu)
 			uint8_t scancode = inportb(0x60);
       on_key(scancode);
 		}
+
+		//Serial interrupts, only the terminal port has them enabled
+		if(cpu->intr == 0x23 || cpu->intr == 0x24)
+		{
+      //Keys typed into the serial terminal
+			uint8_t scancode;
+			while((scancode = terminal_read_key()) != 0)on_key(scancode);
+		}
     if (cpu->intr >= 0x28)
 		{
       //Send EOI to Slave-PIC
@@ -0,0 +1,207 @@
+/*
+ * Presents the 320x200 palette back buffer on a linear frame buffer.
+ * The image is scaled by the largest integer factor that fits and
+ * centered. Every source row is expanded once into a staging row in
+ * RAM by a blitter specialised for the pixel size, then copied to the
+ * frame buffer as often as the scale requires. The frame buffer itself
+ * is write-combining and never read.
+ * Frame buffers with several pages are drawn into one page at a time,
+ * showing a page is up to the display driver.
+ */
+#include "lfb.h"
+
+#include "stdio.h"
+#include "paging.h"
+#include "video.h"
+#include "vga_palette.h"
+
+typedef void (*lfb_expand_fn)(uint8_t *dest, const uint8_t *src, uint16_t width, uint32_t scale);
+
+static struct lfb_format lfb;
+static bool active = false;
+static uint8_t *draw_base = NULL;
+static uint32_t scale = 1;
+static uint32_t origin_x = 0;
+static uint32_t origin_y = 0;
+static uint32_t bytes_per_pixel = 1;
+static lfb_expand_fn expand_row = NULL;
+
+//Palette index to native pixel value
+static uint32_t native_palette[256];
+
+static uint8_t staging_row[LFB_MAX_WIDTH * 4];
+
+/////////////////////////////////////////
+//Row expansion
+/////////////////////////////////////////
+static void expand_row_8(uint8_t *dest, const uint8_t *src, uint16_t width, uint32_t scale)
+{
+	if(scale == 1)
+	{
+		memcpy(dest, src, width);
+		return;
+	}
+	for(uint16_t i = 0; i < width; i++)
+	{
+		uint8_t pixel = src[i];
+		for(uint32_t s = 0; s < scale; s++)*dest++ = pixel;
+	}
+}
+
+static void expand_row_16(uint8_t *dest, const uint8_t *src, uint16_t width, uint32_t scale)
+{
+	uint16_t *out = (uint16_t *)dest;
+	for(uint16_t i = 0; i < width; i++)
+	{
+		uint16_t pixel = native_palette[src[i]];
+		for(uint32_t s = 0; s < scale; s++)*out++ = pixel;
+	}
+}
+
+static void expand_row_24(uint8_t *dest, const uint8_t *src, uint16_t width, uint32_t scale)
+{
+	for(uint16_t i = 0; i < width; i++)
+	{
+		uint32_t pixel = native_palette[src[i]];
+		for(uint32_t s = 0; s < scale; s++)
+		{
+			*dest++ = pixel;
+			*dest++ = pixel >> 8;
+			*dest++ = pixel >> 16;
+		}
+	}
+}
+
+static void expand_row_32(uint8_t *dest, const uint8_t *src, uint16_t width, uint32_t scale)
+{
+	uint32_t *out = (uint32_t *)dest;
+	for(uint16_t i = 0; i < width; i++)
+	{
+		uint32_t pixel = native_palette[src[i]];
+		for(uint32_t s = 0; s < scale; s++)*out++ = pixel;
+	}
+}
+
+//8 bit color channel to a field of the pixel format
+static inline uint32_t color_field(uint8_t value, uint8_t position, uint8_t size)
+{
+	return ((uint32_t)value >> (8 - size)) << position;
+}
+
+/////////////////////////////////////////
+//Frame buffer
+/////////////////////////////////////////
+bool lfb_init(const struct lfb_format *format)
+{
+	switch(format->bpp)
+	{
+		case 8:
+			expand_row = expand_row_8;
+			break;
+		case 15:
+		case 16:
+			expand_row = expand_row_16;
+			break;
+		case 24:
+			expand_row = expand_row_24;
+			break;
+		case 32:
+			expand_row = expand_row_32;
+			break;
+		default:
+			printf("lfb: %d bpp is not supported\n", format->bpp);
+			return false;
+	}
+	if(format->pitch < format->width * ((format->bpp + 7) / 8))
+	{
+		printf("lfb: pitch %d is too small\n", format->pitch);
+		return false;
+	}
+	if(format->width > LFB_MAX_WIDTH || format->width < SCREEN_WIDTH || format->height < SCREEN_HEIGHT)
+	{
+		printf("lfb: %dx%d is not supported\n", format->width, format->height);
+		return false;
+	}
+
+	lfb = *format;
+	if(lfb.pages == 0)lfb.pages = 1;
+	draw_base = (uint8_t *)lfb.base;
+	bytes_per_pixel = (lfb.bpp + 7) / 8;
+
+	uint32_t scale_x = lfb.width / SCREEN_WIDTH;
+	uint32_t scale_y = lfb.height / SCREEN_HEIGHT;
+	scale = scale_x < scale_y ? scale_x : scale_y;
+	origin_x = (lfb.width - SCREEN_WIDTH * scale) / 2;
+	origin_y = (lfb.height - SCREEN_HEIGHT * scale) / 2;
+
+	lfb_set_palette(vga_palette);
+
+	paging_set_write_combining(lfb.base, lfb.pitch * lfb.height * lfb.pages, true);
+	active = true;
+
+	printf("lfb: %dx%dx%d at %x, scale %d\n", lfb.width, lfb.height, lfb.bpp, lfb.base, scale);
+	lfb_clear();
+	return true;
+}
+
+bool lfb_active(void)
+{
+	return active;
+}
+
+//8 bpp frame buffers take palette indices, their colors come from the DAC
+bool lfb_indexed(void)
+{
+	return lfb.bpp == 8;
+}
+
+//Colors for direct color frame buffers, only blits after this use them
+void lfb_set_palette(const uint8_t colors[256][3])
+{
+	for(int i = 0; i < 256; i++)
+	{
+		if(lfb.bpp == 8)native_palette[i] = i;
+		else native_palette[i] = color_field(colors[i][0], lfb.red_position, lfb.red_size)
+			| color_field(colors[i][1], lfb.green_position, lfb.green_size)
+			| color_field(colors[i][2], lfb.blue_position, lfb.blue_size);
+	}
+}
+
+uint32_t lfb_get_scale(void)
+{
+	return scale;
+}
+
+void lfb_set_draw_page(uint32_t page)
+{
+	if(page >= lfb.pages)return;
+	draw_base = (uint8_t *)lfb.base + page * lfb.height * lfb.pitch;
+}
+
+//Clears all pages
+void lfb_clear(void)
+{
+	for(uint32_t row = 0; row < lfb.height * lfb.pages; row++)
+	{
+		memset((uint8_t *)lfb.base + row * lfb.pitch, 0, lfb.width * bytes_per_pixel);
+	}
+}
+
+//Scale a rectangle of the back buffer onto the frame buffer
+void lfb_blit(const uint8_t *buffer, uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+	uint32_t row_bytes = width * scale * bytes_per_pixel;
+	uint8_t *dest = draw_base + (origin_y + y * scale) * lfb.pitch + (origin_x + x * scale) * bytes_per_pixel;
+	const uint8_t *src = buffer + y * SCREEN_WIDTH + x;
+
+	for(uint16_t row = 0; row < height; row++)
+	{
+		expand_row(staging_row, src, width, scale);
+		for(uint32_t s = 0; s < scale; s++)
+		{
+			memcpy(dest, staging_row, row_bytes);
+			dest += lfb.pitch;
+		}
+		src += SCREEN_WIDTH;
+	}
+}
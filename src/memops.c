@@ -0,0 +1,348 @@
+/*
+ * memset and memcpy with runtime dispatch.
+ * Every variant is correct on its own, init_memops checks CPUID, enables
+ * SSE if present and benchmarks the variants on a frame sized buffer.
+ * The fastest one serves all large requests from then on.
+ * Until init_memops runs, the rep movs/stos variant is used.
+ * All variants copy forward, so overlapping copies with the
+ * destination below the source (scrolling) are safe.
+ *
+ * The SSE2 kernels use xmm0-xmm3 without declaring them as clobbered.
+ * The kernel is built without -msse, so the compiler never keeps
+ * anything in these registers and we do not save them on interrupts.
+ */
+#include "memops.h"
+
+#include "cpu.h"
+#include "stdio.h"
+#include "mm.h"
+#include "tsc.h"
+
+#define CR0_EM          0x00000004
+#define CR0_MP          0x00000002
+#define CR4_OSFXSR      0x00000200
+#define CR4_OSXMMEXCPT  0x00000400
+
+typedef void (*memcpy_fn)(void *destination, const void *source, size_t num);
+typedef void (*memset_fn)(void *b, uint8_t c, size_t len);
+
+struct memops_variant
+{
+	const char *name;
+	uint32_t cpuid_edx;
+	memcpy_fn copy;
+	memset_fn set;
+};
+
+/////////////////////////////////////////////////
+//Variants
+/////////////////////////////////////////////////
+
+static void memcpy_bytes(void *destination, const void *source, size_t num)
+{
+	const uint8_t *csrc = source;
+	uint8_t *cdest = destination;
+	for(size_t i = 0; i < num; i++)cdest[i] = csrc[i];
+}
+
+static void memset_bytes(void *b, uint8_t c, size_t len)
+{
+	uint8_t *p = b;
+	for(size_t i = 0; i < len; i++)p[i] = c;
+}
+
+static void memcpy_rep(void *destination, const void *source, size_t num)
+{
+	uint32_t d0, d1, d2;
+	__asm__ volatile(
+		"rep movsl\n\t"
+		"movl %4, %%ecx\n\t"
+		"andl $3, %%ecx\n\t"
+		"jz 1f\n\t"
+		"rep movsb\n\t"
+		"1:"
+		: "=&c" (d0), "=&D" (d1), "=&S" (d2)
+		: "0" (num / 4), "g" (num), "1" (destination), "2" (source)
+		: "memory");
+}
+
+static void memset_rep(void *b, uint8_t c, size_t len)
+{
+	uint32_t d0, d1;
+	__asm__ volatile(
+		"rep stosl\n\t"
+		"movl %4, %%ecx\n\t"
+		"andl $3, %%ecx\n\t"
+		"jz 1f\n\t"
+		"rep stosb\n\t"
+		"1:"
+		: "=&c" (d0), "=&D" (d1)
+		: "0" (len / 4), "a" (c * 0x01010101U), "g" (len), "1" (b)
+		: "memory");
+}
+
+//Byte count until destination is 16 byte aligned
+static inline size_t align_head(const void *destination, size_t num)
+{
+	size_t head = (16 - ((uintptr_t)destination & 15)) & 15;
+	return head < num ? head : num;
+}
+
+//Unaligned loads, aligned stores. With non_temporal the stores bypass
+//the cache, which helps when the destination is not read back soon.
+static inline void memcpy_sse2_common(void *destination, const void *source, size_t num, bool non_temporal)
+{
+	uint8_t *cdest = destination;
+	const uint8_t *csrc = source;
+
+	size_t head = align_head(cdest, num);
+	memcpy_rep(cdest, csrc, head);
+	cdest += head;
+	csrc += head;
+	num -= head;
+
+	size_t blocks = num / 64;
+	if(blocks)
+	{
+		if(non_temporal)
+		{
+			__asm__ volatile(
+				"1:\n\t"
+				"movdqu (%1), %%xmm0\n\t"
+				"movdqu 16(%1), %%xmm1\n\t"
+				"movdqu 32(%1), %%xmm2\n\t"
+				"movdqu 48(%1), %%xmm3\n\t"
+				"movntdq %%xmm0, (%0)\n\t"
+				"movntdq %%xmm1, 16(%0)\n\t"
+				"movntdq %%xmm2, 32(%0)\n\t"
+				"movntdq %%xmm3, 48(%0)\n\t"
+				"addl $64, %0\n\t"
+				"addl $64, %1\n\t"
+				"decl %2\n\t"
+				"jnz 1b\n\t"
+				"sfence"
+				: "+r" (cdest), "+r" (csrc), "+r" (blocks)
+				:
+				: "memory");
+		}
+		else
+		{
+			__asm__ volatile(
+				"1:\n\t"
+				"movdqu (%1), %%xmm0\n\t"
+				"movdqu 16(%1), %%xmm1\n\t"
+				"movdqu 32(%1), %%xmm2\n\t"
+				"movdqu 48(%1), %%xmm3\n\t"
+				"movdqa %%xmm0, (%0)\n\t"
+				"movdqa %%xmm1, 16(%0)\n\t"
+				"movdqa %%xmm2, 32(%0)\n\t"
+				"movdqa %%xmm3, 48(%0)\n\t"
+				"addl $64, %0\n\t"
+				"addl $64, %1\n\t"
+				"decl %2\n\t"
+				"jnz 1b"
+				: "+r" (cdest), "+r" (csrc), "+r" (blocks)
+				:
+				: "memory");
+		}
+	}
+
+	memcpy_rep(cdest, csrc, num & 63);
+}
+
+static inline void memset_sse2_common(void *b, uint8_t c, size_t len, bool non_temporal)
+{
+	uint8_t *p = b;
+
+	size_t head = align_head(p, len);
+	memset_rep(p, c, head);
+	p += head;
+	len -= head;
+
+	size_t blocks = len / 64;
+	if(blocks)
+	{
+		uint32_t fill = c * 0x01010101U;
+		if(non_temporal)
+		{
+			__asm__ volatile(
+				"movd %2, %%xmm0\n\t"
+				"pshufd $0, %%xmm0, %%xmm0\n\t"
+				"1:\n\t"
+				"movntdq %%xmm0, (%0)\n\t"
+				"movntdq %%xmm0, 16(%0)\n\t"
+				"movntdq %%xmm0, 32(%0)\n\t"
+				"movntdq %%xmm0, 48(%0)\n\t"
+				"addl $64, %0\n\t"
+				"decl %1\n\t"
+				"jnz 1b\n\t"
+				"sfence"
+				: "+r" (p), "+r" (blocks)
+				: "r" (fill)
+				: "memory");
+		}
+		else
+		{
+			__asm__ volatile(
+				"movd %2, %%xmm0\n\t"
+				"pshufd $0, %%xmm0, %%xmm0\n\t"
+				"1:\n\t"
+				"movdqa %%xmm0, (%0)\n\t"
+				"movdqa %%xmm0, 16(%0)\n\t"
+				"movdqa %%xmm0, 32(%0)\n\t"
+				"movdqa %%xmm0, 48(%0)\n\t"
+				"addl $64, %0\n\t"
+				"decl %1\n\t"
+				"jnz 1b"
+				: "+r" (p), "+r" (blocks)
+				: "r" (fill)
+				: "memory");
+		}
+	}
+
+	memset_rep(p, c, len & 63);
+}
+
+static void memcpy_sse2(void *destination, const void *source, size_t num)
+{
+	memcpy_sse2_common(destination, source, num, false);
+}
+
+static void memset_sse2(void *b, uint8_t c, size_t len)
+{
+	memset_sse2_common(b, c, len, false);
+}
+
+static void memcpy_sse2_nt(void *destination, const void *source, size_t num)
+{
+	memcpy_sse2_common(destination, source, num, true);
+}
+
+static void memset_sse2_nt(void *b, uint8_t c, size_t len)
+{
+	memset_sse2_common(b, c, len, true);
+}
+
+static const struct memops_variant variants[] =
+{
+	{"bytes",   0,                   memcpy_bytes,   memset_bytes},
+	{"rep",     0,                   memcpy_rep,     memset_rep},
+	{"sse2",    CPUID_FEAT_EDX_SSE2, memcpy_sse2,    memset_sse2},
+	{"sse2-nt", CPUID_FEAT_EDX_SSE2, memcpy_sse2_nt, memset_sse2_nt},
+};
+#define VARIANT_COUNT (sizeof(variants) / sizeof(variants[0]))
+
+static memcpy_fn memcpy_large = memcpy_rep;
+static memset_fn memset_large = memset_rep;
+
+/////////////////////////////////////////////////
+//Dispatch
+/////////////////////////////////////////////////
+
+void *memset(void *b, int c, int len)
+{
+	if(len <= 0)return b;
+
+	if(len < MEMOPS_SMALL_SIZE)memset_rep(b, c, len);
+	else memset_large(b, c, len);
+	return b;
+}
+
+void memcpy(void * destination, const void * source, size_t num)
+{
+	if(num < MEMOPS_SMALL_SIZE)memcpy_rep(destination, source, num);
+	else memcpy_large(destination, source, num);
+}
+
+/////////////////////////////////////////////////
+//Setup
+/////////////////////////////////////////////////
+
+static bool enable_sse(uint32_t edx)
+{
+	if((edx & (CPUID_FEAT_EDX_FXSR | CPUID_FEAT_EDX_SSE)) != (CPUID_FEAT_EDX_FXSR | CPUID_FEAT_EDX_SSE))
+	{
+		return false;
+	}
+
+	uint32_t cr0, cr4;
+	__asm__ volatile("mov %%cr0, %0" : "=r" (cr0));
+	__asm__ volatile("mov %0, %%cr0" : : "r" ((cr0 & ~CR0_EM) | CR0_MP));
+	__asm__ volatile("mov %%cr4, %0" : "=r" (cr4));
+	__asm__ volatile("mov %0, %%cr4" : : "r" (cr4 | CR4_OSFXSR | CR4_OSXMMEXCPT));
+	return true;
+}
+
+void init_memops(void)
+{
+	uint32_t eax, ebx, ecx, edx;
+	cpuid(1, &eax, &ebx, &ecx, &edx);
+
+	if(!enable_sse(edx))
+	{
+		//Without OS support the SSE2 kernels would fault
+		edx &= ~CPUID_FEAT_EDX_SSE2;
+	}
+
+	uint32_t order = mm_size_to_order(MEMOPS_BENCHMARK_SIZE);
+	uint8_t *src = mm_alloc_pages(order);
+	uint8_t *dst = mm_alloc_pages(order);
+	if(src == NULL || dst == NULL)
+	{
+		printf("memops: no memory for the benchmark, using rep\n");
+		if(src)mm_free_pages(src, order);
+		if(dst)mm_free_pages(dst, order);
+		return;
+	}
+
+	//rep is always available and stays in use if the TSC is not calibrated
+	const struct memops_variant *best_copy = &variants[1];
+	const struct memops_variant *best_set = &variants[1];
+	uint32_t best_copy_rate = 0;
+	uint32_t best_set_rate = 0;
+
+	memset_rep(src, 0x5A, MEMOPS_BENCHMARK_SIZE);
+
+	for(uint32_t i = 0; i < VARIANT_COUNT; i++)
+	{
+		const struct memops_variant *v = &variants[i];
+		if((edx & v->cpuid_edx) != v->cpuid_edx)continue;
+
+		//Warm up once so every variant starts with the same cache state
+		v->copy(dst, src, MEMOPS_BENCHMARK_SIZE);
+
+		uint64_t start = rdtsc();
+		for(uint32_t r = 0; r < MEMOPS_BENCHMARK_ROUNDS; r++)
+		{
+			v->copy(dst, src, MEMOPS_BENCHMARK_SIZE);
+		}
+		uint32_t copy_rate = tsc_mb_per_s((uint64_t)MEMOPS_BENCHMARK_SIZE * MEMOPS_BENCHMARK_ROUNDS, rdtsc() - start);
+
+		start = rdtsc();
+		for(uint32_t r = 0; r < MEMOPS_BENCHMARK_ROUNDS; r++)
+		{
+			v->set(dst, r, MEMOPS_BENCHMARK_SIZE);
+		}
+		uint32_t set_rate = tsc_mb_per_s((uint64_t)MEMOPS_BENCHMARK_SIZE * MEMOPS_BENCHMARK_ROUNDS, rdtsc() - start);
+
+		printf("memops: %s memcpy %d MB/s, memset %d MB/s\n", v->name, copy_rate, set_rate);
+
+		if(copy_rate > best_copy_rate)
+		{
+			best_copy = v;
+			best_copy_rate = copy_rate;
+		}
+		if(set_rate > best_set_rate)
+		{
+			best_set = v;
+			best_set_rate = set_rate;
+		}
+	}
+
+	mm_free_pages(src, order);
+	mm_free_pages(dst, order);
+
+	memcpy_large = best_copy->copy;
+	memset_large = best_set->set;
+	printf("memops: using %s memcpy and %s memset\n", best_copy->name, best_set->name);
+}
@@ -0,0 +1,181 @@
+/*
+ * Allocation tracking per call site.
+ * Live allocations are kept in an open addressing hash table that maps
+ * the address to its call site, so frees can be charged to the right site.
+ */
+#include "memtrack.h"
+
+#include "mm.h"
+#include "slab.h"
+#include "stdio.h"
+
+struct memtrack_site
+{
+	const char *site;
+	uint32_t live_count;
+	uint32_t live_bytes;
+	uint32_t total_count;
+};
+
+struct memtrack_slot
+{
+	const void *ptr;
+	uint32_t size;
+	uint8_t site;
+};
+
+struct memtrack_snapshot
+{
+	const char *name;
+	uint32_t live_count[MEMTRACK_MAX_SITES];
+	uint32_t reports;
+};
+
+static struct memtrack_site sites[MEMTRACK_MAX_SITES];
+static uint32_t site_count = 0;
+static struct memtrack_slot slots[MEMTRACK_MAX_LIVE];
+static struct memtrack_snapshot snapshots[MEMTRACK_MAX_REPORTS];
+
+//Allocations that could not be tracked because a table was full
+static uint32_t untracked = 0;
+
+static uint32_t hash_ptr(const void *ptr)
+{
+	//Pages and slab objects are at least 4 byte aligned
+	return (((uintptr_t)ptr >> 2) * 2654435761UL) % MEMTRACK_MAX_LIVE;
+}
+
+static int find_site(const char *site)
+{
+	for(uint32_t i = 0; i < site_count; i++)
+	{
+		if(sites[i].site == site)return i;
+	}
+
+	if(site_count == MEMTRACK_MAX_SITES)return -1;
+
+	sites[site_count].site = site;
+	sites[site_count].live_count = 0;
+	sites[site_count].live_bytes = 0;
+	sites[site_count].total_count = 0;
+	return site_count++;
+}
+
+void memtrack_alloc(const void *ptr, uint32_t size, const char *site)
+{
+	if(ptr == NULL)return;
+
+	int index = find_site(site);
+	if(index < 0)
+	{
+		untracked++;
+		return;
+	}
+
+	uint32_t slot = hash_ptr(ptr);
+	for(uint32_t probe = 0; probe < MEMTRACK_MAX_LIVE; probe++)
+	{
+		if(slots[slot].ptr == NULL)
+		{
+			slots[slot].ptr = ptr;
+			slots[slot].size = size;
+			slots[slot].site = index;
+
+			sites[index].live_count++;
+			sites[index].live_bytes += size;
+			sites[index].total_count++;
+			return;
+		}
+		slot = (slot + 1) % MEMTRACK_MAX_LIVE;
+	}
+
+	untracked++;
+}
+
+//Linear probing deletion without tombstones: move later entries of the
+//probe chain back into the hole so lookups never have to skip freed slots
+static void remove_slot(uint32_t hole)
+{
+	uint32_t next = hole;
+	while(1)
+	{
+		next = (next + 1) % MEMTRACK_MAX_LIVE;
+		if(slots[next].ptr == NULL)break;
+
+		uint32_t home = hash_ptr(slots[next].ptr);
+		bool movable;
+		if(hole <= next)movable = (home <= hole || home > next);
+		else movable = (home <= hole && home > next);
+
+		if(movable)
+		{
+			slots[hole] = slots[next];
+			hole = next;
+		}
+	}
+	slots[hole].ptr = NULL;
+}
+
+void memtrack_free(const void *ptr)
+{
+	if(ptr == NULL)return;
+
+	uint32_t slot = hash_ptr(ptr);
+	for(uint32_t probe = 0; probe < MEMTRACK_MAX_LIVE; probe++)
+	{
+		if(slots[slot].ptr == NULL)return;
+		if(slots[slot].ptr == ptr)
+		{
+			struct memtrack_site *site = &sites[slots[slot].site];
+			site->live_count--;
+			site->live_bytes -= slots[slot].size;
+			remove_slot(slot);
+			return;
+		}
+		slot = (slot + 1) % MEMTRACK_MAX_LIVE;
+	}
+}
+
+static struct memtrack_snapshot *find_snapshot(const char *name)
+{
+	for(int i = 0; i < MEMTRACK_MAX_REPORTS; i++)
+	{
+		if(snapshots[i].name == name || snapshots[i].name == NULL)
+		{
+			snapshots[i].name = name;
+			return &snapshots[i];
+		}
+	}
+	return NULL;
+}
+
+//Print frame counters and live allocations per site over COM1.
+//Growth is measured against the previous report with the same name,
+//so calling this at every game state change shows what each session leaks.
+void memtrack_report(const char *name)
+{
+	struct mm_stats stats;
+	mm_get_stats(&stats);
+
+	struct memtrack_snapshot *snapshot = find_snapshot(name);
+
+	printf("memtrack: ---- %s ----\n", name);
+	printf("memtrack: frames used=%d free=%d total=%d peak=%d\n",
+		stats.used_frames, stats.free_frames, stats.total_frames, stats.peak_used_frames);
+	printf("memtrack: zero pool frames=%d hits=%d misses=%d\n",
+		stats.zero_pool_frames, stats.zero_pool_hits, stats.zero_pool_misses);
+
+	for(uint32_t i = 0; i < site_count; i++)
+	{
+		int growth = 0;
+		if(snapshot != NULL && snapshot->reports != 0)growth = sites[i].live_count - snapshot->live_count[i];
+
+		printf("memtrack: %s live=%d (%d Bytes) total=%d growth=%d%s\n", sites[i].site,
+			sites[i].live_count, sites[i].live_bytes, sites[i].total_count, growth, (growth > 0) ? " LEAK?" : "");
+
+		if(snapshot != NULL)snapshot->live_count[i] = sites[i].live_count;
+	}
+
+	if(snapshot != NULL)snapshot->reports++;
+	if(untracked != 0)printf("memtrack: %d allocations untracked\n", untracked);
+}
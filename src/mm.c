@@ -4,107 +4,374 @@
 #include "mm.h"
 
 #include "stdio.h"
+#include "cpu.h"
 #include "multiboot.h"
+#include "bios_int.h"
+#include "memtrack.h"
 
 #define MM_PAGE_USED 0
 #define MM_PAGE_FREE 1
 #define BITMAP_SIZE 32768
-#define PAGE_SIZE 4096
+//The bitmap covers the 32 bit address space
+#define MM_ADDRESS_LIMIT 0x100000000ULL
+//Memory below this address is never handed out
+#define LOW_MEMORY_RESERVED 0x200000
+
+//'SMAP', expected in EDX/EAX by INT 0x15, EAX = 0xE820
+#define E820_SIGNATURE 0x534D4150
+
+//Number of frames the boot-time self-check allocates
+#define MM_SELFTEST_FRAMES 256
+
+struct e820_entry
+{
+	uint64_t addr;
+	uint64_t len;
+	uint32_t type;
+	uint32_t attributes;
+} __attribute__((packed));
 
 extern const void kernel_start;
 extern const void kernel_end;
 
+//One bit per 4K frame, a set bit means the frame is free.
+//32768 words cover the whole 4 GB address space.
 static uint32_t bitmap[BITMAP_SIZE];
 
+//Summary levels on top of the bitmap. A set bit means the word
+//it stands for on the level below has at least one bit set.
+//bitmap (32768 words) -> summary_l1 (1024) -> summary_l2 (32) -> summary_l3 (1)
+static uint32_t summary_l1[BITMAP_SIZE / 32];
+static uint32_t summary_l2[BITMAP_SIZE / 32 / 32];
+static uint32_t summary_l3;
+
+//Every bitmap word below this index is completely used
+static uint32_t next_free_hint = 0;
+
+//Frame counters. total_frames is fixed once init_mm is done, free_frames
+//counts free bits in the bitmap, buddy_free_pages free pages in the zone.
+static uint32_t total_frames = 0;
+static uint32_t free_frames = 0;
+static uint32_t buddy_free_pages = 0;
+static uint32_t peak_used_frames = 0;
+
+//Frames that have already been cleared for mm_alloc_zeroed.
+//They are taken from the bitmap, so they count as neither free nor used.
+static void * zero_pool[ZERO_POOL_SIZE];
+static uint32_t zero_pool_count = 0;
+static uint32_t zero_pool_hits = 0;
+static uint32_t zero_pool_misses = 0;
+
+//Buddy zone for physically contiguous allocations.
+//The zone is a window of BUDDY_ZONE_PAGES frames starting at a max order
+//boundary. Fully free max order blocks inside the window are taken out of
+//the bitmap at boot and handed to the buddy free lists.
+#define BUDDY_ZONE_PAGES 2048
+#define BUDDY_NOT_FREE 0xFF
+
+struct buddy_block
+{
+	struct buddy_block *next;
+	struct buddy_block *prev;
+};
+
+static uintptr_t buddy_base = 0;
+static uint32_t buddy_pages = 0;
+static struct buddy_block *buddy_free_lists[MM_MAX_ORDER + 1];
+static uint32_t buddy_free_count[MM_MAX_ORDER + 1];
+//Bit n is set if buddy_free_lists[n] is not empty
+static uint32_t buddy_free_mask = 0;
+//Bit n is set if the n-th max order block of the window belongs to the zone
+static uint32_t buddy_owned_blocks = 0;
+//Order of the free block starting at a zone page, BUDDY_NOT_FREE otherwise
+static uint8_t buddy_block_order[BUDDY_ZONE_PAGES];
+
+static void init_buddy(void);
+
+static inline uint32_t bit_count(uint32_t value)
+{
+	uint32_t count = 0;
+	while(value != 0)
+	{
+		value &= value - 1;
+		count++;
+	}
+	return count;
+}
+
+static void update_peak(void)
+{
+	uint32_t used = total_frames - free_frames - buddy_free_pages - zero_pool_count;
+	if(total_frames != 0 && used > peak_used_frames)peak_used_frames = used;
+}
+
+#ifdef MM_SELFTEST
+static void * selftest_frames[MM_SELFTEST_FRAMES];
+static void mm_selftest(void);
+#endif
+
+//Propagate the state of bitmap[index] up through the summary levels
+static void bitmap_word_changed(uint32_t index)
+{
+	uint32_t l1 = index / 32;
+	uint32_t l2 = l1 / 32;
+
+	if(bitmap[index] != 0)
+	{
+		summary_l1[l1] |= 1UL << (index % 32);
+		summary_l2[l2] |= 1UL << (l1 % 32);
+		summary_l3 |= 1UL << l2;
+
+		if(index < next_free_hint)next_free_hint = index;
+		return;
+	}
+
+	summary_l1[l1] &= ~(1UL << (index % 32));
+	if(summary_l1[l1] != 0)return;
+
+	summary_l2[l2] &= ~(1UL << (l1 % 32));
+	if(summary_l2[l2] != 0)return;
+
+	summary_l3 &= ~(1UL << l2);
+}
+
+//Lowest bitmap word with a free frame, BITMAP_SIZE if memory is exhausted
+static uint32_t find_free_word(void)
+{
+	if(next_free_hint < BITMAP_SIZE && bitmap[next_free_hint] != 0)
+		return next_free_hint;
+
+	if(summary_l3 == 0)return BITMAP_SIZE;
+
+	uint32_t l2 = bit_scan_forward(summary_l3);
+	uint32_t l1 = l2 * 32 + bit_scan_forward(summary_l2[l2]);
+	return l1 * 32 + bit_scan_forward(summary_l1[l1]);
+}
+
+//Set or clear the bits of frames [first, last) one bitmap word at a time
+static void bitmap_set_range(uint32_t first, uint32_t last, bool free)
+{
+	while(first < last)
+	{
+		uint32_t index = first / 32;
+		uint32_t bit = first % 32;
+		uint32_t count = 32 - bit;
+		if(count > last - first)count = last - first;
+
+		uint32_t mask = (count == 32) ? 0xFFFFFFFF : (((1UL << count) - 1) << bit);
+		uint32_t old = bitmap[index];
+		if(free)bitmap[index] |= mask;
+		else bitmap[index] &= ~mask;
+
+		uint32_t changed = bit_count(old ^ bitmap[index]);
+		if(free)free_frames += changed;
+		else free_frames -= changed;
+
+		if((old == 0) != (bitmap[index] == 0))bitmap_word_changed(index);
+		first += count;
+	}
+}
+
+//Only whole pages inside [start, end) become free
+void mm_free_range(uint64_t start, uint64_t end)
+{
+	if(end > MM_ADDRESS_LIMIT)end = MM_ADDRESS_LIMIT;
+	uint64_t first = (start + PAGE_SIZE - 1) / PAGE_SIZE;
+	uint64_t last = end / PAGE_SIZE;
+	if(first < last)bitmap_set_range(first, last, true);
+}
+
+//Every page touched by [start, end) is marked as used
+void mm_mark_used_range(uint64_t start, uint64_t end)
+{
+	if(end > MM_ADDRESS_LIMIT)end = MM_ADDRESS_LIMIT;
+	uint64_t first = start / PAGE_SIZE;
+	uint64_t last = (end + PAGE_SIZE - 1) / PAGE_SIZE;
+	if(first < last)bitmap_set_range(first, last, false);
+}
+
+static void apply_memory_region(uint64_t addr, uint64_t len, uint32_t type)
+{
+	printf("mmap: 0x%p - 0x%p type %d\n", (uint32_t)addr, (uint32_t)(addr + len - 1), type);
+	if(type == MULTIBOOT_MEMORY_AVAILABLE)mm_free_range(addr, addr + len);
+}
+
+//Memory map from BIOS INT 0x15, EAX = 0xE820.
+//Returns the number of entries that were applied.
+static int detect_memory_e820(void)
+{
+	struct e820_entry *entry = (struct e820_entry *)BIOS_BUFFER;
+	regs16_t regs;
+	int count = 0;
+
+	//The trampoline loads the segment and index registers from regs as well
+	memset(&regs, 0, sizeof(regs));
+	do
+	{
+		//ACPI 3 attributes, older BIOSes leave this untouched
+		entry->attributes = 1;
+
+		regs.eax = 0xE820;
+		regs.edx = E820_SIGNATURE;
+		regs.ecx = sizeof(struct e820_entry);
+		regs.es = BIOS_BUFFER >> 4;
+		regs.edi = 0;
+		int32(0x15, &regs);
+
+		if((regs.eflags & 0x1) || regs.eax != E820_SIGNATURE)break;
+
+		//Entries flagged as ignored by ACPI 3 are skipped
+		if(regs.ecx < 24 || (entry->attributes & 0x1))
+		{
+			apply_memory_region(entry->addr, entry->len, entry->type);
+			count++;
+		}
+	}
+	while(regs.ebx != 0);
+
+	return count;
+}
+
 void init_mm(struct multiboot_info *mb_info)
 {
-	//Lower and upper memory fields are only valid if the coresponding flag is non null
-	//@TODO
-	printf("mem_lower=%d\n", mb_info->mem_lower);
-	printf("mem_upper=%d\n", mb_info->mem_upper);
+	uint64_t start_tsc = rdtsc();
 
 	//Mark everything as used
-	memset(bitmap, MM_PAGE_USED, BITMAP_SIZE);
+	memset(bitmap, MM_PAGE_USED, sizeof(bitmap));
+	memset(summary_l1, 0, sizeof(summary_l1));
+	memset(summary_l2, 0, sizeof(summary_l2));
+	summary_l3 = 0;
+	next_free_hint = 0;
+	free_frames = 0;
 
-	//Apply memory map from multiboot
-	struct multiboot_mmap_entry* mmap_entry = (void*)mb_info->mmap_addr;
-	for(int i = 0; i < mb_info->mmap_length; i++)
+	//Apply memory map from multiboot.
+	//mmap_length is the size of the buffer in bytes, every entry starts
+	//with its own size which does not include the size field itself.
+	int regions = 0;
+	if(mb_info->flags & MULTIBOOT_INFO_MEM_MAP)
 	{
-		if(mmap_entry->type == MULTIBOOT_MEMORY_AVAILABLE)
+		uintptr_t mmap = mb_info->mmap_addr;
+		uintptr_t mmap_end = mmap + mb_info->mmap_length;
+		while(mmap < mmap_end)
 		{
-			//Free memory:
-			printf("Freeing %d KB at ", (mmap_entry->len / 1024));//@TODO fix printf....
-			printf("0x%p\n", mmap_entry->addr);
+			struct multiboot_mmap_entry* mmap_entry = (void*)mmap;
+			apply_memory_region(mmap_entry->addr, mmap_entry->len, mmap_entry->type);
+			regions++;
 
-			uintptr_t addr = mmap_entry->addr;
-	    uintptr_t end_addr = addr + mmap_entry->len;
-	    while (addr < end_addr)
-			{
-	     	mm_free((void*) addr);
-	     	addr += 0x1000;
-	    }
+			mmap += mmap_entry->size + sizeof(mmap_entry->size);
 		}
+	}
+
+	//No memory map from the bootloader, ask the BIOS
+	if(regions == 0)regions = detect_memory_e820();
 
-		mmap_entry++;
+	//Last resort, lower and upper memory are only valid if the flag is set
+	if(regions == 0 && (mb_info->flags & MULTIBOOT_INFO_MEMORY))
+	{
+		printf("mem_lower=%d KB mem_upper=%d KB\n", mb_info->mem_lower, mb_info->mem_upper);
+		mm_free_range(0, mb_info->mem_lower * 1024);
+		mm_free_range(0x100000, 0x100000 + (uint64_t)mb_info->mem_upper * 1024);
 	}
 
 	//Mark multiboot structure
-	//Structure is probably not larger than 4k
-	mm_mark_used((void *) mb_info);
+	mm_mark_used_range((uintptr_t)mb_info, (uintptr_t)mb_info + sizeof(struct multiboot_info));
+	if(mb_info->flags & MULTIBOOT_INFO_MEM_MAP)
+		mm_mark_used_range(mb_info->mmap_addr, mb_info->mmap_addr + mb_info->mmap_length);
 
 	//Mark multiboot modules as used.
-	mm_mark_used((void*)mb_info->mods_addr);
-	struct multiboot_mod_list* multiboot_mod = (void*)mb_info->mods_addr;
-	printf("Found %d multiboot modules\n", mb_info->mods_count);
-	for(int i = 0; i < mb_info->mods_count; i++)
-	{
-		printf("mod start 0x%p\n", multiboot_mod->mod_start);
-		printf("mod end 0x%p\n", multiboot_mod->mod_end);
-		uintptr_t addr = multiboot_mod->mod_start;
-		uintptr_t end_addr = multiboot_mod->mod_end;
-		while (addr < end_addr)
+	if(mb_info->flags & MULTIBOOT_INFO_MODS)
+	{
+		struct multiboot_mod_list* multiboot_mod = (void*)mb_info->mods_addr;
+		mm_mark_used_range(mb_info->mods_addr, mb_info->mods_addr + mb_info->mods_count * sizeof(struct multiboot_mod_list));
+		printf("Found %d multiboot modules\n", mb_info->mods_count);
+		for(int i = 0; i < mb_info->mods_count; i++)
 		{
-			mm_mark_used((void *) addr);
-			addr += 0x1000;
+			printf("mod 0x%p - 0x%p\n", multiboot_mod->mod_start, multiboot_mod->mod_end);
+			mm_mark_used_range(multiboot_mod->mod_start, multiboot_mod->mod_end);
+			multiboot_mod++;
 		}
-
-		multiboot_mod++;
 	}
 
 	//Mark kernel as used.
-	uintptr_t addr = (uintptr_t) &kernel_start;
-	printf("Kernel start 0x%p\n", addr);
+	printf("Kernel start 0x%p\n", (uintptr_t) &kernel_start);
 	printf("Kernel end 0x%p\n", (uintptr_t) &kernel_end);
-	while (addr < (uintptr_t) &kernel_end)
-	{
-    mm_mark_used((void*) addr);
-  	addr += 0x1000;
-	}
+	mm_mark_used_range((uintptr_t) &kernel_start, (uintptr_t) &kernel_end);
+
+	//Reserve the lowest 2MB (including the first page) because writing
+	//on memory this low causes glitches on real mashines
+	mm_mark_used_range(0, LOW_MEMORY_RESERVED);
+
+	uint32_t setup_cycles = (uint32_t)(rdtsc() - start_tsc);
+	printf("mm: %d KB usable, memory map applied in %d cycles\n", free_frames * 4, setup_cycles);
 
-	//Mark the first page as used
-	mm_mark_used((void*)0x0);
+	#ifdef MM_SELFTEST
+		mm_selftest();
+	#endif
 
-	//@TODO Detect Upper Memory with BIOS INT 0x15, EAX = 0xE820
-	//Alloc 2MB because writing on memory this low causes glitches
-	//on real mashines
-	for(int i = 0; i < 512; i++)mm_alloc();
+	//Reserve the zone for contiguous allocations
+	init_buddy();
+
+	total_frames = free_frames + buddy_free_pages;
 }
 
-void * mm_alloc()
+static void * alloc_frame(void)
 {
-	for(int i = 0; i < BITMAP_SIZE; i++)
+	uint32_t index = find_free_word();
+	next_free_hint = index;
+	if(index == BITMAP_SIZE)return NULL;
+
+	uint32_t bit_index = bit_scan_forward(bitmap[index]);
+	bitmap[index] &= ~(1UL << bit_index);
+	if(bitmap[index] == 0)bitmap_word_changed(index);
+	free_frames--;
+
+	return (void*)(index * 131072 + bit_index * PAGE_SIZE);
+}
+
+void * mm_alloc_site(const char *site)
+{
+	void *frame = alloc_frame();
+	if(frame == NULL)return NULL;
+
+	memtrack_alloc(frame, PAGE_SIZE, site);
+	update_peak();
+	return frame;
+}
+
+//Take a cleared frame from the pool, clear one on the spot if the pool is empty
+void * mm_alloc_zeroed_site(const char *site)
+{
+	void *frame;
+	if(zero_pool_count != 0)
 	{
-		for(int bit_index = 0; bit_index < 32; bit_index++)
-		{
-			if(bitmap[i] & (1 << bit_index))
-			{
-				bitmap[i] &= ~(1UL << bit_index);
-				return (void*)(i * 131072 + bit_index * PAGE_SIZE);
-			}
-		}
+		frame = zero_pool[--zero_pool_count];
+		zero_pool_hits++;
+	}
+	else
+	{
+		frame = alloc_frame();
+		if(frame == NULL)return NULL;
+		memset(frame, 0, PAGE_SIZE);
+		zero_pool_misses++;
 	}
 
-	return NULL;
+	memtrack_alloc(frame, PAGE_SIZE, site);
+	update_peak();
+	return frame;
+}
+
+//Clear one frame for the pool. Meant to be called while the CPU is idle,
+//returns false once the pool is full or memory is exhausted.
+bool mm_zero_pool_refill(void)
+{
+	if(zero_pool_count == ZERO_POOL_SIZE)return false;
+
+	void *frame = alloc_frame();
+	if(frame == NULL)return false;
+
+	memset(frame, 0, PAGE_SIZE);
+	zero_pool[zero_pool_count++] = frame;
+	return true;
 }
 
 void mm_free(void * addr)
@@ -116,8 +383,14 @@ void mm_free(void * addr)
 	int index = address / PAGE_SIZE / 32;
 	int bit = (address / PAGE_SIZE) % 32;
 
+	memtrack_free(addr);
+
 	if(!CHECK_BIT(bitmap[index], bit))
+	{
 		bitmap[index] |= 1UL << bit;
+		if(bitmap[index] == (1UL << bit))bitmap_word_changed(index);
+		free_frames++;
+	}
 }
 
 void mm_mark_used(void * addr)
@@ -134,5 +407,280 @@ void mm_mark_used(void * addr)
 	int bit = (address / PAGE_SIZE) % 32;
 
 	if(CHECK_BIT(bitmap[index], bit))
+	{
 		bitmap[index] &= ~(1UL << bit);
+		if(bitmap[index] == 0)bitmap_word_changed(index);
+		free_frames--;
+		update_peak();
+	}
+}
+
+void mm_get_stats(struct mm_stats *stats)
+{
+	stats->total_frames = total_frames;
+	stats->free_frames = free_frames + buddy_free_pages;
+	stats->used_frames = total_frames - stats->free_frames - zero_pool_count;
+	stats->peak_used_frames = peak_used_frames;
+	stats->zero_pool_frames = zero_pool_count;
+	stats->zero_pool_hits = zero_pool_hits;
+	stats->zero_pool_misses = zero_pool_misses;
+}
+
+/////////////////////////////////////////
+//Buddy allocator
+/////////////////////////////////////////
+static void buddy_list_push(uint32_t order, uint32_t page)
+{
+	struct buddy_block *block = (struct buddy_block *)(buddy_base + page * PAGE_SIZE);
+	block->prev = NULL;
+	block->next = buddy_free_lists[order];
+	if(block->next != NULL)block->next->prev = block;
+	buddy_free_lists[order] = block;
+
+	buddy_block_order[page] = order;
+	buddy_free_count[order]++;
+	buddy_free_pages += 1UL << order;
+	buddy_free_mask |= 1UL << order;
+}
+
+static void buddy_list_remove(uint32_t order, uint32_t page)
+{
+	struct buddy_block *block = (struct buddy_block *)(buddy_base + page * PAGE_SIZE);
+	if(block->prev != NULL)block->prev->next = block->next;
+	else buddy_free_lists[order] = block->next;
+	if(block->next != NULL)block->next->prev = block->prev;
+
+	buddy_block_order[page] = BUDDY_NOT_FREE;
+	buddy_free_count[order]--;
+	buddy_free_pages -= 1UL << order;
+	if(buddy_free_lists[order] == NULL)buddy_free_mask &= ~(1UL << order);
+}
+
+//Move fully free max order blocks from the bitmap into the buddy zone.
+//At most half of the free memory is taken so mm_alloc keeps enough frames.
+static void init_buddy(void)
+{
+	const uint32_t block_pages = 1UL << MM_MAX_ORDER;
+	const uint32_t block_words = block_pages / 32;
+	uint32_t budget = free_frames / 2;
+
+	for(uint32_t i = 0; i < BUDDY_ZONE_PAGES; i++)buddy_block_order[i] = BUDDY_NOT_FREE;
+
+	for(uint32_t word = 0; word < BITMAP_SIZE; word += block_words)
+	{
+		bool block_free = true;
+		for(uint32_t i = 0; i < block_words; i++)
+		{
+			if(bitmap[word + i] != 0xFFFFFFFF)block_free = false;
+		}
+		if(!block_free)continue;
+
+		uint32_t page = word * 32;
+		if(buddy_pages == 0)buddy_base = page * PAGE_SIZE;
+
+		uint32_t zone_page = page - buddy_base / PAGE_SIZE;
+		if(zone_page + block_pages > BUDDY_ZONE_PAGES || buddy_pages + block_pages > budget)break;
+
+		bitmap_set_range(page, page + block_pages, false);
+
+		buddy_list_push(MM_MAX_ORDER, zone_page);
+		buddy_owned_blocks |= 1UL << (zone_page >> MM_MAX_ORDER);
+		buddy_pages += block_pages;
+	}
+
+	printf("buddy: %d KB zone at 0x%p\n", buddy_pages * 4, buddy_base);
+	mm_print_buddy_stats();
+}
+
+uint32_t mm_size_to_order(size_t size)
+{
+	uint32_t order = 0;
+	while((PAGE_SIZE << order) < size)order++;
+	return order;
+}
+
+void * mm_alloc_pages_site(uint32_t order, const char *site)
+{
+	if(order > MM_MAX_ORDER)return NULL;
+
+	uint32_t available = buddy_free_mask & ~((1UL << order) - 1);
+	if(available == 0)
+	{
+		//Single pages can still come from the bitmap
+		if(order == 0)return mm_alloc_site(site);
+		return NULL;
+	}
+
+	uint32_t current = bit_scan_forward(available);
+	uint32_t page = ((uintptr_t)buddy_free_lists[current] - buddy_base) / PAGE_SIZE;
+	buddy_list_remove(current, page);
+
+	//Split until the block has the requested size, the upper halves stay free
+	while(current > order)
+	{
+		current--;
+		buddy_list_push(current, page + (1UL << current));
+	}
+
+	void *block = (void *)(buddy_base + page * PAGE_SIZE);
+	memtrack_alloc(block, PAGE_SIZE << order, site);
+	update_peak();
+	return block;
+}
+
+void mm_free_pages(void * addr, uint32_t order)
+{
+	memtrack_free(addr);
+
+	uintptr_t address = (uintptr_t)addr;
+	uint32_t page = (address - buddy_base) / PAGE_SIZE;
+	if(address < buddy_base || page >= BUDDY_ZONE_PAGES
+		|| !CHECK_BIT(buddy_owned_blocks, page >> MM_MAX_ORDER))
+	{
+		//Single pages may have come from the bitmap fallback
+		if(order == 0)mm_free(addr);
+		else printf("buddy: 0x%p is outside of the zone\n", addr);
+		return;
+	}
+
+	if(order > MM_MAX_ORDER || (page & ((1UL << order) - 1)) != 0 || buddy_block_order[page] != BUDDY_NOT_FREE)
+	{
+		printf("buddy: invalid free of 0x%p order %d\n", addr, order);
+		return;
+	}
+
+	//Merge with the buddy as long as it is a free block of the same order
+	while(order < MM_MAX_ORDER)
+	{
+		uint32_t buddy = page ^ (1UL << order);
+		if(buddy >= BUDDY_ZONE_PAGES || buddy_block_order[buddy] != order)break;
+
+		buddy_list_remove(order, buddy);
+		page &= ~(1UL << order);
+		order++;
+	}
+
+	buddy_list_push(order, page);
+}
+
+void mm_print_buddy_stats(void)
+{
+	uint32_t free_pages = 0;
+	uint32_t largest = 0;
+
+	for(uint32_t order = 0; order <= MM_MAX_ORDER; order++)
+	{
+		free_pages += buddy_free_count[order] << order;
+		if(buddy_free_count[order] != 0)largest = order;
+		printf("buddy: order %d (%d KB) free blocks=%d\n", order, 4 << order, buddy_free_count[order]);
+	}
+
+	//Share of free memory that is split into blocks smaller than the largest one
+	uint32_t fragmentation = 0;
+	if(free_pages != 0)fragmentation = 100 - (buddy_free_count[largest] << largest) * 100 / free_pages;
+	printf("buddy: %d of %d KB free, largest block %d KB, fragmentation %d%%\n",
+		free_pages * 4, buddy_pages * 4, (free_pages != 0) ? (4 << largest) : 0, fragmentation);
+}
+
+#ifdef MM_SELFTEST
+static uint32_t mm_count_free(void)
+{
+	uint32_t count = 0;
+	for(int i = 0; i < BITMAP_SIZE; i++)
+	{
+		uint32_t word = bitmap[i];
+		while(word != 0)
+		{
+			word &= word - 1;
+			count++;
+		}
+	}
+	return count;
+}
+
+//Reference implementation: the linear scan the summary levels replaced.
+//Returns the frame the old mm_alloc would have handed out, without taking it.
+static void * mm_find_linear(void)
+{
+	for(int i = 0; i < BITMAP_SIZE; i++)
+	{
+		for(int bit_index = 0; bit_index < 32; bit_index++)
+		{
+			if(bitmap[i] & (1UL << bit_index))
+			{
+				return (void*)(i * 131072 + bit_index * PAGE_SIZE);
+			}
+		}
+	}
+
+	return NULL;
+}
+
+static bool mm_check_summaries(void)
+{
+	for(int i = 0; i < BITMAP_SIZE; i++)
+	{
+		if((bitmap[i] != 0) != (CHECK_BIT(summary_l1[i / 32], i % 32) != 0))return false;
+	}
+
+	for(int i = 0; i < BITMAP_SIZE / 32; i++)
+	{
+		if((summary_l1[i] != 0) != (CHECK_BIT(summary_l2[i / 32], i % 32) != 0))return false;
+	}
+
+	for(int i = 0; i < BITMAP_SIZE / 32 / 32; i++)
+	{
+		if((summary_l2[i] != 0) != (CHECK_BIT(summary_l3, i) != 0))return false;
+	}
+
+	return true;
+}
+
+//Allocate one frame and compare it with what the linear scan would have returned
+static bool mm_selftest_alloc(void **frame)
+{
+	void *expected = mm_find_linear();
+	*frame = mm_alloc();
+	if(*frame == expected)return true;
+
+	printf("mm: self-check failed, got 0x%p expected 0x%p\n", *frame, expected);
+	return false;
+}
+
+//Compare the summary allocator against the linear scan.
+//Allocates a batch of frames, frees every second one from the top down
+//so the free hint has to move backwards, reallocates and releases everything.
+static void mm_selftest(void)
+{
+	int count = 0;
+
+	for(; count < MM_SELFTEST_FRAMES; count++)
+	{
+		if(!mm_selftest_alloc(&selftest_frames[count]))return;
+		if(selftest_frames[count] == NULL)break;
+	}
+
+	for(int i = count - 1; i >= 0; i -= 2)mm_free(selftest_frames[i]);
+
+	for(int i = count - 1; i >= 0; i -= 2)
+	{
+		if(!mm_selftest_alloc(&selftest_frames[i]))return;
+	}
+
+	for(int i = 0; i < count; i++)mm_free(selftest_frames[i]);
+
+	if(!mm_check_summaries())
+	{
+		printf("mm: self-check failed, summary levels out of sync\n");
+		return;
+	}
+
+	if(mm_count_free() != free_frames)
+	{
+		printf("mm: self-check failed, %d free frames counted but %d in the bitmap\n", free_frames, mm_count_free());
+		return;
+	}
+
+	printf("mm: self-check passed (%d frames)\n", count);
 }
+#endif
@@ -0,0 +1,317 @@
+/*
+ * Mode X backend.
+ * Mode 13h is switched to unchained planar 320x240 (Mode X) by
+ * reprogramming the sequencer and CRTC. Without chain-4 the whole 256 KB
+ * of VRAM is addressable, which leaves room for two pages and static
+ * images. Frames are drawn into the hidden page and shown by changing
+ * the CRTC start address, so presenting copies nothing.
+ * Static images are copied VRAM to VRAM through the latches, four
+ * pixels per byte access.
+ */
+#include "modex.h"
+
+#include "stdio.h"
+#include "bios_int.h"
+#include "font.h"
+#include "paging.h"
+#include "video.h"
+#include "vga.h"
+
+//Linear staging area for text and images before they are split into planes
+#define MODEX_SCRATCH_SIZE 4096
+#define MODEX_GLYPH_ADVANCE 9
+
+//320x240 at 60 Hz, index in the low byte, value in the high byte
+static const uint16_t modex_crtc[] =
+{
+	0x0D06, //Vertical total
+	0x3E07, //Overflow
+	0x4109, //Cell height, two scan lines per row
+	0xEA10, //Vertical sync start
+	0xAC11, //Vertical sync end, protects registers 0-7 again
+	0xDF12, //Vertical displayed
+	0x0014, //Dword mode off
+	0xE715, //Vertical blank start
+	0x0616, //Vertical blank end
+	0xE317, //Byte mode on
+};
+
+static volatile uint8_t *const vram = (volatile uint8_t *)MODE_13H_MEMORY;
+
+static uint8_t visible_page = 0;
+static uint8_t draw_page = 1;
+static uint16_t static_used = 0;
+
+static uint8_t scratch[MODEX_SCRATCH_SIZE];
+
+static inline void set_map_mask(uint8_t planes)
+{
+	outport(VGA_SC_INDEX, (planes << 8) | VGA_SC_MAP_MASK);
+}
+
+static inline uint16_t page_offset(uint8_t page)
+{
+	return page * MODEX_PAGE_SIZE;
+}
+
+//Split linear pixels into planes, column c of the source lands at x + c
+static void write_planar(uint16_t offset, uint16_t pitch, const uint8_t *pixels, uint16_t width, uint16_t height, uint16_t x)
+{
+	for(uint8_t plane = 0; plane < 4; plane++)
+	{
+		//First source column that falls into this plane
+		uint16_t first = (plane - x) & 3;
+		if(first >= width)continue;
+
+		set_map_mask(1 << plane);
+		for(uint16_t row = 0; row < height; row++)
+		{
+			const uint8_t *src = pixels + row * width;
+			volatile uint8_t *dest = vram + offset + row * pitch;
+			for(uint16_t c = first; c < width; c += 4)dest[(x + c) >> 2] = src[c];
+		}
+	}
+}
+
+void modex_init(void)
+{
+	regs16_t regs;
+	memset(&regs, 0, sizeof(regs));
+	regs.ax = 0x0013;
+	int32(0x10, &regs);
+
+	//Planar writes depend on the register state at the time they reach
+	//the card, they must not be combined or reordered
+	paging_set_write_combining(MODE_13H_MEMORY, MODEX_VRAM_SIZE, false);
+
+	//Turn off chain-4
+	outport(VGA_SC_INDEX, 0x0600 | VGA_SC_MEMORY_MODE);
+
+	//25 MHz dot clock and 480 scan lines, the sequencer is held in reset meanwhile
+	outport(VGA_SC_INDEX, 0x0100 | VGA_SC_RESET);
+	outportb(VGA_MISC_OUTPUT, 0xE3);
+	outport(VGA_SC_INDEX, 0x0300 | VGA_SC_RESET);
+
+	//Unprotect CRTC registers 0-7
+	outportb(VGA_CRTC_INDEX, VGA_CRTC_V_RETRACE_END);
+	outportb(VGA_CRTC_DATA, inportb(VGA_CRTC_DATA) & 0x7F);
+
+	for(uint32_t i = 0; i < sizeof(modex_crtc) / sizeof(modex_crtc[0]); i++)
+	{
+		outport(VGA_CRTC_INDEX, modex_crtc[i]);
+	}
+
+	set_map_mask(0x0F);
+	memset((void *)vram, 0, MODEX_VRAM_SIZE);
+
+	visible_page = 0;
+	draw_page = 1;
+	static_used = 0;
+	outport(VGA_CRTC_INDEX, VGA_CRTC_START_HIGH);
+	outport(VGA_CRTC_INDEX, VGA_CRTC_START_LOW);
+
+	printf("modex: %dx%d, %d pages, %d Bytes per plane for static images\n", MODEX_WIDTH, MODEX_HEIGHT,
+		MODEX_PAGES, MODEX_VRAM_SIZE - MODEX_STATIC_OFFSET);
+}
+
+void modex_clear(uint8_t color)
+{
+	set_map_mask(0x0F);
+	memset((void *)(vram + page_offset(draw_page)), color, MODEX_PAGE_SIZE);
+}
+
+void modex_set_pixel(uint16_t x, uint16_t y, uint8_t color)
+{
+	set_map_mask(1 << (x & 3));
+	vram[page_offset(draw_page) + y * MODEX_PITCH + (x >> 2)] = color;
+}
+
+//Edge bytes get a partial plane mask, everything between is written to all planes at once
+void modex_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	if(width == 0 || height == 0)return;
+
+	uint16_t first = x >> 2;
+	uint16_t last = (x + width - 1) >> 2;
+	uint8_t left_mask = (0x0F << (x & 3)) & 0x0F;
+	uint8_t right_mask = 0x0F >> (3 - ((x + width - 1) & 3));
+	volatile uint8_t *line = vram + page_offset(draw_page) + y * MODEX_PITCH;
+
+	if(first == last)
+	{
+		set_map_mask(left_mask & right_mask);
+		for(uint16_t row = 0; row < height; row++)line[row * MODEX_PITCH + first] = color;
+		return;
+	}
+
+	set_map_mask(left_mask);
+	for(uint16_t row = 0; row < height; row++)line[row * MODEX_PITCH + first] = color;
+
+	if(last - first > 1)
+	{
+		set_map_mask(0x0F);
+		for(uint16_t row = 0; row < height; row++)
+		{
+			memset((void *)(line + row * MODEX_PITCH + first + 1), color, last - first - 1);
+		}
+	}
+
+	set_map_mask(right_mask);
+	for(uint16_t row = 0; row < height; row++)line[row * MODEX_PITCH + last] = color;
+}
+
+//Same placement as m13hb_draw_sprite, one pass over the spans per plane
+void modex_draw_sprite(const struct sprite *sprite, int16_t x, int16_t y)
+{
+	int32_t top = y + 1;
+	int32_t first_row = top < 0 ? -top : 0;
+	int32_t last_row = sprite->height;
+	if(top + last_row > MODEX_HEIGHT)last_row = MODEX_HEIGHT - top;
+
+	int32_t clip_left = x < 0 ? -x : 0;
+	int32_t clip_right = sprite->width;
+	if(x + clip_right > MODEX_WIDTH)clip_right = MODEX_WIDTH - x;
+
+	if(first_row >= last_row || clip_left >= clip_right)return;
+
+	volatile uint8_t *page = vram + page_offset(draw_page);
+	for(uint8_t plane = 0; plane < 4; plane++)
+	{
+		set_map_mask(1 << plane);
+		for(int32_t row = first_row; row < last_row; row++)
+		{
+			volatile uint8_t *line = page + (top + row) * MODEX_PITCH;
+			const struct sprite_span *span = sprite->spans + sprite->rows[row];
+			const struct sprite_span *end = sprite->spans + sprite->rows[row + 1];
+			for(; span < end; span++)
+			{
+				int32_t start = span->x < clip_left ? clip_left : span->x;
+				int32_t stop = span->x + span->length;
+				if(stop > clip_right)stop = clip_right;
+
+				//First column of the run that falls into this plane
+				start += (plane - (x + start)) & 3;
+				const uint8_t *src = sprite->pixels + span->offset - span->x;
+				for(int32_t c = start; c < stop; c += 4)line[(x + c) >> 2] = src[c];
+			}
+		}
+	}
+}
+
+//Text with background, glyphs advance by 9 pixels like m13hb_puts
+void modex_puts(uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, const char *s)
+{
+	uint16_t length = strlen(s);
+	if(length == 0)return;
+
+	uint16_t width = length * MODEX_GLYPH_ADVANCE - 1;
+	if(x + width > MODEX_WIDTH)width = MODEX_WIDTH - x;
+	if(width * 8 > MODEX_SCRATCH_SIZE)return;
+
+	for(uint8_t row = 0; row < 8; row++)
+	{
+		for(uint16_t c = 0; c < width; c++)
+		{
+			uint8_t glyph = s[c / MODEX_GLYPH_ADVANCE] & 0x7F;
+			uint8_t column = c % MODEX_GLYPH_ADVANCE;
+			bool set = column < 8 && ((font_data[glyph][row] >> (7 - column)) & 0x1);
+			scratch[row * width + c] = set ? color : bg_color;
+		}
+	}
+
+	write_planar(page_offset(draw_page) + y * MODEX_PITCH, MODEX_PITCH, scratch, width, 8, x);
+}
+
+//Render a sprite on bg_color into off-screen VRAM for modex_blit_image
+bool modex_store_sprite(struct modex_image *image, const struct sprite *sprite, uint8_t bg_color)
+{
+	uint16_t width = (sprite->width + 3) & ~3;
+	uint16_t size = (width / 4) * sprite->height;
+	if(width * sprite->height > MODEX_SCRATCH_SIZE || MODEX_STATIC_OFFSET + static_used + size > MODEX_VRAM_SIZE)
+	{
+		printf("modex: no room for a %dx%d image\n", sprite->width, sprite->height);
+		return false;
+	}
+
+	memset(scratch, bg_color, width * sprite->height);
+	for(uint16_t row = 0; row < sprite->height; row++)
+	{
+		const struct sprite_span *span = sprite->spans + sprite->rows[row];
+		const struct sprite_span *end = sprite->spans + sprite->rows[row + 1];
+		for(; span < end; span++)
+		{
+			memcpy(scratch + row * width + span->x, sprite->pixels + span->offset, span->length);
+		}
+	}
+
+	image->width = width;
+	image->height = sprite->height;
+	image->offset = MODEX_STATIC_OFFSET + static_used;
+	static_used += size;
+
+	write_planar(image->offset, width / 4, scratch, width, sprite->height, 0);
+	return true;
+}
+
+//Copy rows of bytes VRAM to VRAM in write mode 1, every write stores the
+//four latches loaded by the last read, so each byte moves four pixels
+static void latch_copy(volatile uint8_t *dest, const volatile uint8_t *src, uint16_t bytes, uint16_t rows, uint16_t src_pitch)
+{
+	outportb(VGA_GC_INDEX, VGA_GC_MODE);
+	uint8_t mode = inportb(VGA_GC_DATA);
+	outportb(VGA_GC_DATA, (mode & ~0x03) | 0x01);
+	set_map_mask(0x0F);
+
+	for(uint16_t row = 0; row < rows; row++)
+	{
+		for(uint16_t i = 0; i < bytes; i++)dest[i] = src[i];
+		dest += MODEX_PITCH;
+		src += src_pitch;
+	}
+
+	outportb(VGA_GC_DATA, mode);
+}
+
+//Latch copy into the hidden page, x is rounded down to a multiple of 4.
+//The image keeps the sprite placement, it covers rows y + 1 to y + height.
+void modex_blit_image(const struct modex_image *image, uint16_t x, uint16_t y)
+{
+	uint16_t bytes = image->width / 4;
+	uint16_t rows = image->height;
+	if(y + 1 >= MODEX_HEIGHT)return;
+	if(y + 1 + rows > MODEX_HEIGHT)rows = MODEX_HEIGHT - y - 1;
+
+	latch_copy(vram + page_offset(draw_page) + (y + 1) * MODEX_PITCH + (x >> 2),
+		vram + image->offset, bytes, rows, bytes);
+}
+
+//Bring an area of the hidden page up to date with the visible one,
+//whole groups of four pixels are copied
+void modex_copy_visible(uint16_t x, uint16_t y, uint16_t width, uint16_t height)
+{
+	if(width == 0 || height == 0)return;
+
+	uint16_t first = x >> 2;
+	uint16_t bytes = ((x + width + 3) >> 2) - first;
+	uint16_t offset = y * MODEX_PITCH + first;
+	latch_copy(vram + page_offset(draw_page) + offset, vram + page_offset(visible_page) + offset,
+		bytes, height, MODEX_PITCH);
+}
+
+//Show the hidden page and start drawing into the other one
+void modex_flip(void)
+{
+	uint16_t offset = page_offset(draw_page);
+
+	//The start address is latched at the beginning of the retrace,
+	//write both halves while the display is active
+	while(inportb(VGA_INPUT_STATUS) & VGA_DISPLAY_DISABLED){}
+	outport(VGA_CRTC_INDEX, (offset & 0xFF00) | VGA_CRTC_START_HIGH);
+	outport(VGA_CRTC_INDEX, (offset << 8) | VGA_CRTC_START_LOW);
+
+	//Drawing into the old page is safe once the new one was latched
+	while(!(inportb(VGA_INPUT_STATUS) & VGA_RETRACE)){}
+
+	visible_page = draw_page;
+	draw_page = (draw_page + 1) % MODEX_PAGES;
+}
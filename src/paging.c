@@ -0,0 +1,133 @@
+/*
+ * Identity mapping of the whole 4 GB address space.
+ * The first 4 MB are mapped with 4K pages so the VGA aperture can get its
+ * own caching attributes, everything above uses 4 MB PSE pages.
+ * Write-combining is selected through PAT entry 1 (PWT set, PCD clear),
+ * which is reprogrammed from write-through to write-combining.
+ * A write-combining PAT type wins over an uncacheable MTRR, so this also
+ * works for the legacy VGA window the firmware marks as UC.
+ */
+#include "paging.h"
+
+#include "cpu.h"
+#include "stdio.h"
+
+#define PAGE_PRESENT    0x001
+#define PAGE_WRITE      0x002
+#define PAGE_PWT        0x008
+#define PAGE_PCD        0x010
+#define PAGE_LARGE      0x080
+
+#define CR0_PG          0x80000000
+#define CR4_PSE         0x00000010
+
+#define MSR_PAT         0x277
+//PA0 WB, PA1 WC, PA2 UC-, PA3 UC, upper half unchanged from the reset value
+#define PAT_VALUE       0x0007040600070106ULL
+
+#define LARGE_PAGE_SIZE 0x400000
+
+//Mode 13h frame buffer window
+#define VGA_APERTURE      0xA0000
+#define VGA_APERTURE_SIZE 0x10000
+
+static uint32_t page_directory[1024] __attribute__((aligned(4096)));
+static uint32_t low_page_table[1024] __attribute__((aligned(4096)));
+
+static bool paging_active = false;
+static bool pat_supported = false;
+
+static inline void invlpg(uintptr_t addr)
+{
+	__asm__ volatile("invlpg (%0)" : : "r" (addr) : "memory");
+}
+
+static inline void wbinvd(void)
+{
+	__asm__ volatile("wbinvd" : : : "memory");
+}
+
+void init_paging(void)
+{
+	uint32_t eax, ebx, ecx, edx;
+	cpuid(1, &eax, &ebx, &ecx, &edx);
+
+	if(!(edx & CPUID_FEAT_EDX_PSE))
+	{
+		printf("paging: no PSE support, paging stays disabled\n");
+		return;
+	}
+	pat_supported = (edx & CPUID_FEAT_EDX_PAT) != 0;
+
+	for(uint32_t i = 0; i < 1024; i++)
+	{
+		low_page_table[i] = (i * 4096) | PAGE_PRESENT | PAGE_WRITE;
+		page_directory[i] = (i * LARGE_PAGE_SIZE) | PAGE_PRESENT | PAGE_WRITE | PAGE_LARGE;
+	}
+	page_directory[0] = (uintptr_t)low_page_table | PAGE_PRESENT | PAGE_WRITE;
+
+	if(pat_supported)
+	{
+		wbinvd();
+		wrmsr(MSR_PAT, PAT_VALUE);
+		wbinvd();
+	}
+
+	uint32_t cr4;
+	__asm__ volatile("mov %%cr4, %0" : "=r" (cr4));
+	__asm__ volatile("mov %0, %%cr4" : : "r" (cr4 | CR4_PSE));
+	__asm__ volatile("mov %0, %%cr3" : : "r" (page_directory));
+
+	uint32_t cr0;
+	__asm__ volatile("mov %%cr0, %0" : "=r" (cr0));
+	__asm__ volatile("mov %0, %%cr0" : : "r" (cr0 | CR0_PG));
+	paging_active = true;
+
+	paging_set_write_combining(VGA_APERTURE, VGA_APERTURE_SIZE, true);
+
+	printf("paging: enabled, 4 MB pages, write-combining %s\n", pat_supported ? "on" : "unavailable");
+}
+
+bool paging_enabled(void)
+{
+	return paging_active;
+}
+
+bool paging_write_combining_supported(void)
+{
+	return paging_active && pat_supported;
+}
+
+//Regions in the first 4 MB are changed page by page, above that the
+//whole 4 MB pages covering the region change their type.
+void paging_set_write_combining(uintptr_t addr, size_t size, bool enable)
+{
+	if(!paging_write_combining_supported())return;
+
+	uintptr_t end = addr + size;
+	while(addr < end)
+	{
+		uint32_t *entry;
+		uintptr_t step;
+		if(addr < LARGE_PAGE_SIZE)
+		{
+			entry = &low_page_table[addr / 4096];
+			step = 4096 - (addr % 4096);
+		}
+		else
+		{
+			entry = &page_directory[addr / LARGE_PAGE_SIZE];
+			step = LARGE_PAGE_SIZE - (addr % LARGE_PAGE_SIZE);
+		}
+
+		if(enable)*entry = (*entry & ~PAGE_PCD) | PAGE_PWT;
+		else *entry &= ~(PAGE_PWT | PAGE_PCD);
+
+		invlpg(addr);
+		if(addr + step < addr)break;
+		addr += step;
+	}
+
+	//Write back anything cached under the old memory type
+	wbinvd();
+}
@@ -0,0 +1,216 @@
+/*
+ * VGA DAC palette manager.
+ * Fades, flashes and color cycling only change the 256 palette entries,
+ * uploading them costs 768 port writes instead of redrawing 64000 pixels.
+ * palette_update recomputes the active palette from the saved one and
+ * remembers the range of entries that changed. palette_flush uploads that
+ * range, m13hb_present calls it right after the retrace started so the
+ * DAC is not written while the picture is scanned out.
+ * Direct color frame buffers have no DAC, there the LFB color table is
+ * rebuilt and the whole screen presented again.
+ */
+#include "palette.h"
+
+#include "stdio.h"
+#include "lfb.h"
+#include "vga.h"
+#include "video.h"
+#include "vga_palette.h"
+
+struct palette_cycle
+{
+	uint8_t first;
+	uint8_t count;
+	uint32_t period;
+	uint32_t start;
+};
+
+static uint8_t saved[PALETTE_SIZE][3];
+static uint8_t active[PALETTE_SIZE][3];
+
+//Entries that differ from what was uploaded, dirty_first > dirty_last if none
+static uint16_t dirty_first = PALETTE_SIZE;
+static uint16_t dirty_last = 0;
+
+//The fade level moves from fade_from to fade_to within fade_duration ticks
+static uint8_t fade_color[3] = {0, 0, 0};
+static uint16_t fade_level = 0;
+static uint16_t fade_from = 0;
+static uint16_t fade_to = 0;
+static uint32_t fade_start = 0;
+static uint32_t fade_duration = 0;
+
+static struct palette_cycle cycles[PALETTE_MAX_CYCLES];
+static uint8_t cycle_count = 0;
+
+static inline void mark_dirty(uint16_t index)
+{
+	if(index < dirty_first)dirty_first = index;
+	if(index > dirty_last)dirty_last = index;
+}
+
+//Saved color of an entry after color cycling
+static const uint8_t *cycled_color(uint16_t index, uint32_t now)
+{
+	for(uint8_t i = 0; i < cycle_count; i++)
+	{
+		struct palette_cycle *cycle = &cycles[i];
+		if(index < cycle->first || index >= cycle->first + cycle->count)continue;
+
+		uint32_t phase = ((now - cycle->start) / cycle->period) % cycle->count;
+		return saved[cycle->first + (index - cycle->first + phase) % cycle->count];
+	}
+	return saved[index];
+}
+
+//The BIOS and the LFB renderer start out with the mode 13h colors
+void init_palette(void)
+{
+	memcpy(saved, vga_palette, sizeof(saved));
+	memcpy(active, vga_palette, sizeof(active));
+	dirty_first = PALETTE_SIZE;
+	dirty_last = 0;
+	fade_level = 0;
+	fade_from = 0;
+	fade_to = 0;
+	cycle_count = 0;
+}
+
+//Changes show up with the next palette_update
+void palette_set(uint8_t index, uint8_t red, uint8_t green, uint8_t blue)
+{
+	saved[index][0] = red;
+	saved[index][1] = green;
+	saved[index][2] = blue;
+}
+
+void palette_load(const uint8_t colors[PALETTE_SIZE][3])
+{
+	memcpy(saved, colors, sizeof(saved));
+}
+
+const uint8_t *palette_get_active(void)
+{
+	return &active[0][0];
+}
+
+const uint8_t *palette_get_saved(void)
+{
+	return &saved[0][0];
+}
+
+static void start_fade(uint16_t from, uint16_t to, uint32_t now, uint32_t duration)
+{
+	fade_from = from;
+	fade_to = to;
+	fade_start = now;
+	fade_duration = duration;
+	if(duration == 0)fade_level = to;
+}
+
+//Blend towards a solid color until only that color is left
+void palette_fade_out(uint8_t red, uint8_t green, uint8_t blue, uint32_t now, uint32_t duration)
+{
+	fade_color[0] = red;
+	fade_color[1] = green;
+	fade_color[2] = blue;
+	start_fade(fade_level, PALETTE_FADE_FULL, now, duration);
+}
+
+//Back to the saved palette from wherever the last fade stopped
+void palette_fade_in(uint32_t now, uint32_t duration)
+{
+	start_fade(fade_level, 0, now, duration);
+}
+
+//Jump to a solid color and fade back
+void palette_flash(uint8_t red, uint8_t green, uint8_t blue, uint32_t now, uint32_t duration)
+{
+	fade_color[0] = red;
+	fade_color[1] = green;
+	fade_color[2] = blue;
+	fade_level = PALETTE_FADE_FULL;
+	start_fade(PALETTE_FADE_FULL, 0, now, duration);
+}
+
+bool palette_fading(void)
+{
+	return fade_level != fade_to;
+}
+
+//Rotate count entries starting at first by one every period ticks
+bool palette_add_cycle(uint8_t first, uint8_t count, uint32_t period, uint32_t now)
+{
+	if(cycle_count == PALETTE_MAX_CYCLES || count < 2 || period == 0 || first + count > PALETTE_SIZE)return false;
+
+	struct palette_cycle *cycle = &cycles[cycle_count++];
+	cycle->first = first;
+	cycle->count = count;
+	cycle->period = period;
+	cycle->start = now;
+	return true;
+}
+
+//Cycled entries go back to their saved colors with the next palette_update
+void palette_clear_cycles(void)
+{
+	cycle_count = 0;
+}
+
+//Recompute the active palette for this point in time
+void palette_update(uint32_t now)
+{
+	if(fade_level != fade_to)
+	{
+		uint32_t elapsed = now - fade_start;
+		if(elapsed >= fade_duration)fade_level = fade_to;
+		else fade_level = fade_from + ((int32_t)fade_to - fade_from) * (int32_t)elapsed / (int32_t)fade_duration;
+	}
+
+	for(uint16_t i = 0; i < PALETTE_SIZE; i++)
+	{
+		const uint8_t *color = cycled_color(i, now);
+		for(uint8_t c = 0; c < 3; c++)
+		{
+			uint8_t value = color[c] + (((int32_t)fade_color[c] - color[c]) * fade_level) / PALETTE_FADE_FULL;
+			if(active[i][c] != value)
+			{
+				active[i][c] = value;
+				mark_dirty(i);
+			}
+		}
+	}
+}
+
+bool palette_pending(void)
+{
+	return dirty_first <= dirty_last;
+}
+
+//Upload the changed entries now, callers time this to the retrace.
+//Returns false if nothing changed.
+bool palette_flush(void)
+{
+	if(!palette_pending())return false;
+
+	if(lfb_active() && !lfb_indexed())
+	{
+		lfb_set_palette(active);
+		m13hb_invalidate();
+	}
+	else
+	{
+		//The DAC takes 6 bit values and advances its index on its own
+		outportb(VGA_DAC_WRITE_INDEX, dirty_first);
+		for(uint16_t i = dirty_first; i <= dirty_last; i++)
+		{
+			outportb(VGA_DAC_DATA, active[i][0] >> 2);
+			outportb(VGA_DAC_DATA, active[i][1] >> 2);
+			outportb(VGA_DAC_DATA, active[i][2] >> 2);
+		}
+	}
+
+	dirty_first = PALETTE_SIZE;
+	dirty_last = 0;
+	return true;
+}
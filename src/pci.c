@@ -0,0 +1,93 @@
+/*
+ * PCI configuration space access through the 0xCF8/0xCFC ports.
+ * All buses are scanned once at startup, the devices found are kept in a
+ * small table that drivers search by vendor and device id.
+ */
+#include "pci.h"
+
+#include "stdio.h"
+
+static struct pci_device devices[PCI_MAX_DEVICES];
+static uint32_t device_count = 0;
+
+static inline uint32_t config_address(uint8_t bus, uint8_t slot, uint8_t function, uint8_t offset)
+{
+	return 0x80000000 | (bus << 16) | (slot << 11) | (function << 8) | (offset & 0xFC);
+}
+
+static uint32_t config_read32(uint8_t bus, uint8_t slot, uint8_t function, uint8_t offset)
+{
+	outportl(PCI_CONFIG_ADDRESS, config_address(bus, slot, function, offset));
+	return inportl(PCI_CONFIG_DATA);
+}
+
+static void add_function(uint8_t bus, uint8_t slot, uint8_t function)
+{
+	uint32_t id = config_read32(bus, slot, function, PCI_VENDOR_ID);
+	if((id & 0xFFFF) == PCI_NO_DEVICE)return;
+
+	uint32_t class = config_read32(bus, slot, function, PCI_CLASS);
+	printf("pci: %d:%d.%d %x:%x class %x:%x\n", bus, slot, function, id & 0xFFFF, id >> 16,
+		class >> 24, (class >> 16) & 0xFF);
+
+	if(device_count == PCI_MAX_DEVICES)return;
+	struct pci_device *device = &devices[device_count++];
+	device->bus = bus;
+	device->slot = slot;
+	device->function = function;
+	device->vendor_id = id & 0xFFFF;
+	device->device_id = id >> 16;
+	device->class_code = class >> 24;
+	device->subclass = (class >> 16) & 0xFF;
+}
+
+void init_pci(void)
+{
+	device_count = 0;
+	for(uint32_t bus = 0; bus < 256; bus++)
+	{
+		for(uint8_t slot = 0; slot < 32; slot++)
+		{
+			if((config_read32(bus, slot, 0, PCI_VENDOR_ID) & 0xFFFF) == PCI_NO_DEVICE)continue;
+
+			uint8_t header = config_read32(bus, slot, 0, PCI_HEADER_TYPE) >> 16;
+			uint8_t functions = (header & PCI_HEADER_MULTI_FUNCTION) ? 8 : 1;
+			for(uint8_t function = 0; function < functions; function++)add_function(bus, slot, function);
+		}
+	}
+	printf("pci: %d devices\n", device_count);
+}
+
+uint32_t pci_read32(const struct pci_device *device, uint8_t offset)
+{
+	return config_read32(device->bus, device->slot, device->function, offset);
+}
+
+uint16_t pci_read16(const struct pci_device *device, uint8_t offset)
+{
+	return pci_read32(device, offset) >> ((offset & 2) * 8);
+}
+
+void pci_write32(const struct pci_device *device, uint8_t offset, uint32_t value)
+{
+	outportl(PCI_CONFIG_ADDRESS, config_address(device->bus, device->slot, device->function, offset));
+	outportl(PCI_CONFIG_DATA, value);
+}
+
+//First device with these ids, NULL if there is none
+const struct pci_device *pci_find_device(uint16_t vendor_id, uint16_t device_id)
+{
+	for(uint32_t i = 0; i < device_count; i++)
+	{
+		if(devices[i].vendor_id == vendor_id && devices[i].device_id == device_id)return &devices[i];
+	}
+	return NULL;
+}
+
+//Base address of a 32 bit memory BAR, 0 for I/O BARs
+uintptr_t pci_memory_bar(const struct pci_device *device, uint8_t bar)
+{
+	uint32_t value = pci_read32(device, PCI_BAR0 + bar * 4);
+	if(value & PCI_BAR_IO)return 0;
+	return value & ~0xF;
+}
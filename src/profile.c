@@ -0,0 +1,269 @@
+/*
+ * Frame time profiler.
+ * Stages are timed with rdtsc between profile_begin and profile_end, the
+ * TSC rate comes from the PIT calibration in tsc.c. profile_frame_end
+ * closes a frame and keeps min, max, average and the last PROFILE_HISTORY
+ * samples per stage for the 99th percentile.
+ * profile=overlay on the kernel command line draws the numbers in the
+ * lower left corner of the screen, profile=csv sends one line per frame
+ * over COM1 every PROFILE_CSV_INTERVAL frames, profile=all does both.
+ */
+#include "profile.h"
+
+#include "stdio.h"
+#include "cpu.h"
+#include "tsc.h"
+#include "cmdline.h"
+#include "renderer.h"
+
+#define OVERLAY_COLUMNS 30
+#define OVERLAY_NAME_COLUMNS 9
+#define OVERLAY_COLOR 0x0f
+//The 99th percentile is at most the PROFILE_HISTORY / 100 + 1 largest sample
+#define PERCENTILE_RANK_MAX (PROFILE_HISTORY / 100 + 1)
+
+struct profile_stage
+{
+	char name[PROFILE_NAME_LENGTH];
+	uint64_t start;
+	//Cycles in the running frame
+	uint32_t current;
+
+	uint32_t min;
+	uint32_t max;
+	uint64_t total;
+	uint32_t history[PROFILE_HISTORY];
+};
+
+//Stage values shown by the overlay, in microseconds
+struct overlay_line
+{
+	uint32_t min;
+	uint32_t avg;
+	uint32_t max;
+	uint32_t p99;
+};
+
+static struct profile_stage stages[PROFILE_MAX_STAGES];
+static uint8_t stage_count = 0;
+static uint32_t frames = 0;
+
+static bool overlay = false;
+static bool csv = false;
+static bool csv_header_sent = false;
+static struct overlay_line overlay_lines[PROFILE_MAX_STAGES];
+
+//Frames since the last CSV block
+static uint32_t csv_frames = 0;
+static uint32_t csv_first_frame = 0;
+static uint32_t csv_lengths[PROFILE_CSV_INTERVAL];
+static uint32_t csv_cycles[PROFILE_CSV_INTERVAL][PROFILE_MAX_STAGES];
+
+static void set_name(struct profile_stage *stage, const char *name)
+{
+	size_t i = 0;
+	while(name[i] && i < PROFILE_NAME_LENGTH - 1)
+	{
+		stage->name[i] = name[i];
+		i++;
+	}
+	stage->name[i] = '\0';
+}
+
+//profile=overlay, csv or all
+void init_profile(void)
+{
+	stage_count = 0;
+	profile_add_stage("total");
+	profile_reset();
+
+	const char *option = cmdline_get("profile");
+	if(option == NULL)return;
+
+	overlay = strcmp(option, "overlay") == 0 || strcmp(option, "all") == 0;
+	csv = strcmp(option, "csv") == 0 || strcmp(option, "all") == 0;
+	if(!overlay && !csv)
+	{
+		printf("profile: unknown option %s\n", option);
+		return;
+	}
+	printf("profile: overlay %s, csv %s\n", overlay ? "on" : "off", csv ? "on" : "off");
+}
+
+//Returns the stage id, stages beyond PROFILE_MAX_STAGES all end up in the last one
+uint8_t profile_add_stage(const char *name)
+{
+	if(stage_count == PROFILE_MAX_STAGES)return PROFILE_MAX_STAGES - 1;
+
+	struct profile_stage *stage = &stages[stage_count];
+	set_name(stage, name);
+	stage->current = 0;
+	stage->min = 0xFFFFFFFF;
+	stage->max = 0;
+	stage->total = 0;
+	return stage_count++;
+}
+
+void profile_reset(void)
+{
+	for(uint8_t i = 0; i < stage_count; i++)
+	{
+		stages[i].current = 0;
+		stages[i].min = 0xFFFFFFFF;
+		stages[i].max = 0;
+		stages[i].total = 0;
+		overlay_lines[i].min = 0;
+		overlay_lines[i].avg = 0;
+		overlay_lines[i].max = 0;
+		overlay_lines[i].p99 = 0;
+	}
+	frames = 0;
+	csv_frames = 0;
+}
+
+void profile_begin(uint8_t stage)
+{
+	stages[stage].start = rdtsc();
+}
+
+void profile_end(uint8_t stage)
+{
+	stages[stage].current += (uint32_t)(rdtsc() - stages[stage].start);
+}
+
+void profile_frame_begin(void)
+{
+	profile_begin(PROFILE_FRAME);
+}
+
+//Largest samples kept sorted in top, the 99th percentile is the rank-th
+static uint32_t percentile_99(struct profile_stage *stage)
+{
+	uint32_t count = frames < PROFILE_HISTORY ? frames : PROFILE_HISTORY;
+	if(count == 0)return 0;
+
+	uint32_t rank = count / 100 + 1;
+	uint32_t top[PERCENTILE_RANK_MAX];
+	uint32_t used = 0;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		uint32_t value = stage->history[i];
+		if(used < rank)used++;
+		else if(value <= top[rank - 1])continue;
+
+		uint32_t j = used - 1;
+		while(j > 0 && top[j - 1] < value)
+		{
+			top[j] = top[j - 1];
+			j--;
+		}
+		top[j] = value;
+	}
+	return top[rank - 1];
+}
+
+static void update_overlay(void)
+{
+	for(uint8_t i = 0; i < stage_count; i++)
+	{
+		struct profile_stage *stage = &stages[i];
+		overlay_lines[i].min = tsc_cycles_to_us(stage->min);
+		overlay_lines[i].avg = tsc_cycles_to_us(div64_32(stage->total, frames));
+		overlay_lines[i].max = tsc_cycles_to_us(stage->max);
+		overlay_lines[i].p99 = tsc_cycles_to_us(percentile_99(stage));
+	}
+}
+
+//One line per frame: profile,frame,snake length,cycles per stage
+static void send_csv(void)
+{
+	if(!csv_header_sent)
+	{
+		printf("profile,frame,length");
+		for(uint8_t i = 0; i < stage_count; i++)printf(",%s", stages[i].name);
+		printf("\n");
+		csv_header_sent = true;
+	}
+
+	for(uint32_t row = 0; row < csv_frames; row++)
+	{
+		printf("profile,%d,%d", csv_first_frame + row, csv_lengths[row]);
+		for(uint8_t i = 0; i < stage_count; i++)printf(",%d", csv_cycles[row][i]);
+		printf("\n");
+	}
+	csv_frames = 0;
+}
+
+void profile_frame_end(uint32_t snake_length)
+{
+	profile_end(PROFILE_FRAME);
+
+	if(csv_frames == 0)csv_first_frame = frames;
+	csv_lengths[csv_frames] = snake_length;
+
+	for(uint8_t i = 0; i < stage_count; i++)
+	{
+		struct profile_stage *stage = &stages[i];
+		uint32_t cycles = stage->current;
+		if(cycles < stage->min)stage->min = cycles;
+		if(cycles > stage->max)stage->max = cycles;
+		stage->total += cycles;
+		stage->history[frames % PROFILE_HISTORY] = cycles;
+		csv_cycles[csv_frames][i] = cycles;
+		stage->current = 0;
+	}
+	frames++;
+	csv_frames++;
+
+	//Printing takes long, it is left for the end of a block
+	if(overlay && frames % PROFILE_OVERLAY_INTERVAL == 0)update_overlay();
+	if(csv_frames == PROFILE_CSV_INTERVAL)
+	{
+		if(csv)send_csv();
+		else csv_frames = 0;
+	}
+}
+
+bool profile_overlay_enabled(void)
+{
+	return overlay;
+}
+
+//min/avg/max/p99 in microseconds, the stage names are cut to fit
+void profile_draw_overlay(uint16_t x, uint16_t y)
+{
+	if(!overlay)return;
+
+	renderer_fill_rect(x, y, OVERLAY_COLUMNS * 8, (stage_count + 1) * 8, 0x00);
+	renderer_printf(x, y, OVERLAY_COLOR, "us min/avg/max/p99");
+	for(uint8_t i = 0; i < stage_count; i++)
+	{
+		char name[OVERLAY_NAME_COLUMNS];
+		uint8_t length = 0;
+		while(stages[i].name[length] && length < OVERLAY_NAME_COLUMNS - 1)
+		{
+			name[length] = stages[i].name[length];
+			length++;
+		}
+		name[length] = '\0';
+
+		struct overlay_line *line = &overlay_lines[i];
+		uint16_t line_y = y + (i + 1) * 8;
+		renderer_printf(x, line_y, OVERLAY_COLOR, "%s", name);
+		renderer_printf(x + OVERLAY_NAME_COLUMNS * 8, line_y, OVERLAY_COLOR, "%d/%d/%d/%d",
+			line->min, line->avg, line->max, line->p99);
+	}
+}
+
+void profile_print_stats(void)
+{
+	if(frames == 0)return;
+
+	printf("profile: %d frames, tsc %d kHz, cycles min/avg/max/p99\n", frames, tsc_get_khz());
+	for(uint8_t i = 0; i < stage_count; i++)
+	{
+		struct profile_stage *stage = &stages[i];
+		printf("profile: %s %d/%d/%d/%d\n", stage->name, stage->min,
+			div64_32(stage->total, frames), stage->max, percentile_99(stage));
+	}
+}
@@ -0,0 +1,204 @@
+/*
+ * Renderer backends.
+ * The game draws through the renderer_* functions instead of writing into
+ * the mode 13h back buffer, renderer= on the kernel command line picks the
+ * backend:
+ *   vga   back buffer presented through mode 13h, VBE, DISPI or the boot LFB
+ *   modex planar 320x240 Mode X, draws into the hidden page and flips it
+ *   text  80x25 text mode at 0xB8000, needs no mode switch and no BIOS
+ *   null  draws nothing, frame times show the game logic alone
+ * If the serial terminal is active it gets every call as well.
+ */
+#include "renderer.h"
+
+#include "stdio.h"
+#include "stdarg.h"
+#include "arena.h"
+#include "cmdline.h"
+#include "palette.h"
+#include "terminal.h"
+#include "tilemap.h"
+#include "vga_palette.h"
+
+//Text mode has the first 16 colors of the default palette
+#define TEXT_COLORS 16
+
+static const struct renderer *targets[RENDERER_MAX_TARGETS];
+static uint8_t target_count = 0;
+
+static struct renderer_tile tiles[TILEMAP_MAX_TILES];
+
+/////////////////////////////////////////
+//Null backend
+/////////////////////////////////////////
+static bool null_init(void)
+{
+	return true;
+}
+
+static void null_clear(void)
+{
+}
+
+static void null_fill_rect(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+}
+
+static void null_blit_tile(uint16_t x, uint16_t y, uint8_t tile)
+{
+}
+
+static void null_draw_sprite(const struct sprite *sprite, int16_t x, int16_t y)
+{
+}
+
+static void null_draw_text(int16_t x, int16_t y, uint8_t color, const char *text)
+{
+}
+
+const struct renderer renderer_null =
+{
+	"null",
+	null_init,
+	null_clear,
+	null_fill_rect,
+	null_fill_rect,
+	null_blit_tile,
+	null_draw_sprite,
+	null_draw_text,
+	null_clear,
+};
+
+/////////////////////////////////////////
+//Setup
+/////////////////////////////////////////
+//renderer=vga, modex, text or null. A backend that fails falls back to the next one.
+void init_renderer(void)
+{
+	static const struct renderer *const backends[] = {&renderer_m13h, &renderer_modex, &renderer_text, &renderer_null};
+	const char *option = cmdline_get("renderer");
+
+	uint8_t first = 0;
+	if(option != NULL)
+	{
+		while(first < sizeof(backends) / sizeof(backends[0]) && strcmp(option, backends[first]->name) != 0)first++;
+		if(first == sizeof(backends) / sizeof(backends[0]))
+		{
+			printf("renderer: unknown backend %s\n", option);
+			first = 0;
+		}
+	}
+
+	target_count = 0;
+	for(uint8_t i = first; i < sizeof(backends) / sizeof(backends[0]); i++)
+	{
+		if(backends[i]->init())
+		{
+			targets[target_count++] = backends[i];
+			break;
+		}
+		printf("renderer: %s failed, falling back\n", backends[i]->name);
+	}
+
+	//The terminal draws alongside, e.g. renderer=null terminal=com1 for headless runs
+	if(renderer_ansi.init())targets[target_count++] = &renderer_ansi;
+
+	printf("renderer: %s%s\n", targets[0]->name, target_count > 1 ? " and terminal" : "");
+}
+
+const char *renderer_get_name(void)
+{
+	return targets[0]->name;
+}
+
+void renderer_set_tile(uint8_t tile, struct sprite *sprite, char glyph, uint8_t color)
+{
+	if(tile >= TILEMAP_MAX_TILES)return;
+	tiles[tile].sprite = sprite;
+	tiles[tile].glyph = glyph;
+	tiles[tile].color = color;
+}
+
+//Tiles without a look are empty
+const struct renderer_tile *renderer_get_tile(uint8_t tile)
+{
+	static const struct renderer_tile empty = {NULL, ' ', 0};
+	if(tile == TILE_EMPTY || tile >= TILEMAP_MAX_TILES)return &empty;
+	return &tiles[tile];
+}
+
+//Nearest by squared distance, from the saved palette so fades do not matter
+uint8_t renderer_text_color(uint8_t color)
+{
+	const uint8_t *rgb = palette_get_saved() + color * 3;
+	uint8_t best = 0;
+	uint32_t best_distance = 0xFFFFFFFF;
+	for(uint8_t i = 0; i < TEXT_COLORS; i++)
+	{
+		int32_t r = (int32_t)rgb[0] - vga_palette[i][0];
+		int32_t g = (int32_t)rgb[1] - vga_palette[i][1];
+		int32_t b = (int32_t)rgb[2] - vga_palette[i][2];
+		uint32_t distance = r * r + g * g + b * b;
+		if(distance < best_distance)
+		{
+			best = i;
+			best_distance = distance;
+		}
+	}
+	return best;
+}
+
+/////////////////////////////////////////
+//Drawing
+/////////////////////////////////////////
+void renderer_clear(void)
+{
+	for(uint8_t i = 0; i < target_count; i++)targets[i]->clear();
+}
+
+void renderer_fill_rect(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	for(uint8_t i = 0; i < target_count; i++)targets[i]->fill_rect(x, y, width, height, color);
+}
+
+void renderer_hline(int16_t x, int16_t y, uint16_t length, uint8_t color)
+{
+	renderer_fill_rect(x, y, length, 1, color);
+}
+
+void renderer_draw_frame(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	for(uint8_t i = 0; i < target_count; i++)targets[i]->draw_frame(x, y, width, height, color);
+}
+
+void renderer_blit_tile(uint16_t x, uint16_t y, uint8_t tile)
+{
+	for(uint8_t i = 0; i < target_count; i++)targets[i]->blit_tile(x, y, tile);
+}
+
+void renderer_draw_sprite(const struct sprite *sprite, int16_t x, int16_t y)
+{
+	for(uint8_t i = 0; i < target_count; i++)targets[i]->draw_sprite(sprite, x, y);
+}
+
+//The line is formatted into frame scratch memory, backends copy what they keep
+int renderer_printf(int16_t x, int16_t y, uint8_t color, const char *fmt, ...)
+{
+	struct arena_marker marker = arena_mark(&frame_arena);
+	char *text = arena_alloc(&frame_arena, RENDERER_FORMAT_LENGTH);
+	if(text == NULL)return 0;
+
+	va_list ap;
+	va_start(ap, fmt);
+	int length = vsnprintf(text, RENDERER_FORMAT_LENGTH, fmt, ap);
+	va_end(ap);
+
+	for(uint8_t i = 0; i < target_count; i++)targets[i]->draw_text(x, y, color, text);
+	arena_release(&frame_arena, marker);
+	return length;
+}
+
+void renderer_present(void)
+{
+	for(uint8_t i = 0; i < target_count; i++)targets[i]->present();
+}
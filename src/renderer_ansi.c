@@ -0,0 +1,93 @@
+/*
+ * Serial terminal renderer.
+ * Passes the drawing on to the 40x25 cells of terminal.c, one character
+ * per 8x8 pixel cell. It only draws if terminal= is set and then runs
+ * next to the selected renderer.
+ */
+#include "renderer.h"
+
+#include "terminal.h"
+#include "tilemap.h"
+
+#define ANSI_CELL_SIZE TILE_SIZE
+
+//Text mode colors are ordered blue, green, red, ANSI colors red, green, blue
+static const uint8_t ansi_colors[8] =
+{
+	TERMINAL_BLACK, TERMINAL_BLUE, TERMINAL_GREEN, TERMINAL_CYAN,
+	TERMINAL_RED, TERMINAL_MAGENTA, TERMINAL_YELLOW, TERMINAL_WHITE,
+};
+
+static uint8_t ansi_color(uint8_t color)
+{
+	uint8_t text_color = renderer_text_color(color);
+	return ansi_colors[text_color & 7] | (text_color & TERMINAL_BRIGHT);
+}
+
+static bool ansi_init(void)
+{
+	return terminal_active();
+}
+
+static void ansi_fill_rect(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	if(width == 0 || height == 0 || x < 0 || y < 0)return;
+
+	uint16_t x0 = x / ANSI_CELL_SIZE;
+	uint16_t y0 = y / ANSI_CELL_SIZE;
+	uint16_t x1 = (x + width + ANSI_CELL_SIZE - 1) / ANSI_CELL_SIZE;
+	uint16_t y1 = (y + height + ANSI_CELL_SIZE - 1) / ANSI_CELL_SIZE;
+
+	//Rectangles lower than a character become a line
+	char c = ' ';
+	if(height < ANSI_CELL_SIZE)c = '-';
+	else if(width < ANSI_CELL_SIZE)c = '|';
+
+	for(uint16_t cy = y0; cy < y1; cy++)terminal_hline(x0, cy, x1 - x0, c, ansi_color(color));
+}
+
+static void ansi_draw_frame(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	if(width == 0 || height == 0 || x < 0 || y < 0)return;
+
+	uint16_t x0 = x / ANSI_CELL_SIZE;
+	uint16_t y0 = y / ANSI_CELL_SIZE;
+	uint16_t x1 = (x + width + ANSI_CELL_SIZE - 1) / ANSI_CELL_SIZE;
+	uint16_t y1 = (y + height + ANSI_CELL_SIZE - 1) / ANSI_CELL_SIZE;
+
+	terminal_draw_frame(x0, y0, x1 - x0, y1 - y0, ansi_color(color));
+}
+
+static void ansi_blit_tile(uint16_t x, uint16_t y, uint8_t tile)
+{
+	const struct renderer_tile *look = renderer_get_tile(tile);
+	terminal_put(x, y, look->glyph, ansi_color(look->color));
+}
+
+static void ansi_draw_sprite(const struct sprite *sprite, int16_t x, int16_t y)
+{
+}
+
+static void ansi_draw_text(int16_t x, int16_t y, uint8_t color, const char *text)
+{
+	if(x < 0 || y < 0)return;
+	terminal_printf(x / ANSI_CELL_SIZE, y / ANSI_CELL_SIZE, ansi_color(color), "%s", text);
+}
+
+static void ansi_present(void)
+{
+	terminal_present();
+}
+
+const struct renderer renderer_ansi =
+{
+	"ansi",
+	ansi_init,
+	terminal_clear,
+	ansi_fill_rect,
+	ansi_draw_frame,
+	ansi_blit_tile,
+	ansi_draw_sprite,
+	ansi_draw_text,
+	ansi_present,
+};
@@ -0,0 +1,90 @@
+/*
+ * Mode 13h renderer.
+ * Draws into a 320x200 back buffer, m13hb_present copies the damaged parts
+ * to mode 13h, a VBE or DISPI mode or the boot loader frame buffer.
+ */
+#include "renderer.h"
+
+#include "stdio.h"
+#include "mm.h"
+#include "video.h"
+#include "tilemap.h"
+
+static uint8_t *screen_buffer = NULL;
+
+static bool m13h_init(void)
+{
+	//Physically contiguous 64 KB block from the buddy allocator, taken
+	//before the mode switch so text mode still works if it fails
+	screen_buffer = (uint8_t *) mm_alloc_pages(mm_size_to_order(SCREEN_WIDTH * SCREEN_HEIGHT));
+	if(screen_buffer == NULL)
+	{
+		printf("Allocation of the screen buffer failed.\n");
+		return false;
+	}
+
+	//Change videomode, the boot loader frame buffer, VBE or mode 13h
+	init_video();
+
+	//Compare uncached and write-combining copies to VGA memory
+	m13hb_cls(screen_buffer);
+	m13hb_benchmark_present(screen_buffer);
+
+	//Present during the vertical retrace so frames do not tear
+	m13hb_init_vsync();
+	return true;
+}
+
+static void m13h_clear(void)
+{
+	m13hb_cls(screen_buffer);
+}
+
+static void m13h_fill_rect(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	m13hb_draw_rect(screen_buffer, x, y, width, height, color);
+}
+
+static void m13h_draw_frame(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	m13hb_draw_frame(screen_buffer, x, y, width, height, color);
+}
+
+static void m13h_blit_tile(uint16_t x, uint16_t y, uint8_t tile)
+{
+	const struct renderer_tile *look = renderer_get_tile(tile);
+	x *= TILE_SIZE;
+	y *= TILE_SIZE;
+
+	//Sprites land one row below the cell origin, clear exactly the rows they cover
+	m13hb_draw_rect(screen_buffer, x, y + 1, TILE_SIZE, TILE_SIZE, 0x00);
+	if(look->sprite != NULL)m13hb_draw_sprite(screen_buffer, look->sprite, x, y);
+}
+
+static void m13h_draw_sprite(const struct sprite *sprite, int16_t x, int16_t y)
+{
+	m13hb_draw_sprite(screen_buffer, sprite, x, y);
+}
+
+static void m13h_draw_text(int16_t x, int16_t y, uint8_t color, const char *text)
+{
+	m13hb_puts(screen_buffer, x, y, color, 0x00, text);
+}
+
+static void m13h_present(void)
+{
+	m13hb_present(screen_buffer);
+}
+
+const struct renderer renderer_m13h =
+{
+	"vga",
+	m13h_init,
+	m13h_clear,
+	m13h_fill_rect,
+	m13h_draw_frame,
+	m13h_blit_tile,
+	m13h_draw_sprite,
+	m13h_draw_text,
+	m13h_present,
+};
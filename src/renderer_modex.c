@@ -0,0 +1,206 @@
+/*
+ * Mode X renderer.
+ * Draws straight into the hidden page of modex.c and shows it with a CRTC
+ * start address flip, nothing is copied from system memory. The game
+ * screen is centered in the 240 lines of Mode X.
+ * The game only redraws what changed, but after a flip the hidden page is
+ * the one shown two frames ago. Everything drawn since the last flip is
+ * therefore copied from the visible page into the hidden one through the
+ * latches right after flipping.
+ * Large sprites at x positions divisible by 4, like the menu logo, are
+ * kept in off-screen VRAM and latch copied as well. Their transparent
+ * pixels become black, which is the background wherever the game draws them.
+ */
+#include "renderer.h"
+
+#include "stdio.h"
+#include "modex.h"
+#include "palette.h"
+#include "tilemap.h"
+
+//First Mode X line of the game screen
+#define MODEX_TOP ((MODEX_HEIGHT - RENDERER_HEIGHT) / 2)
+
+//Areas drawn since the last flip, further areas are merged into one
+#define MODEX_DAMAGE_RECTS 32
+
+//Sprites from this size on are latch copied, and how many are kept
+#define MODEX_LATCH_MIN_PIXELS 512
+#define MODEX_IMAGE_SLOTS 4
+
+struct modex_rect
+{
+	int16_t x0;
+	int16_t y0;
+	int16_t x1;
+	int16_t y1;
+};
+
+struct modex_slot
+{
+	const struct sprite *sprite;
+	struct modex_image image;
+	bool stored;
+};
+
+static struct modex_rect damage[MODEX_DAMAGE_RECTS];
+static uint8_t damage_count = 0;
+
+static struct modex_slot slots[MODEX_IMAGE_SLOTS];
+
+//Clip to the game screen, false if nothing is left
+static bool clip(int16_t x, int16_t y, int16_t width, int16_t height, struct modex_rect *r)
+{
+	r->x0 = x < 0 ? 0 : x;
+	r->y0 = y < 0 ? 0 : y;
+	r->x1 = x + width > RENDERER_WIDTH ? RENDERER_WIDTH : x + width;
+	r->y1 = y + height > RENDERER_HEIGHT ? RENDERER_HEIGHT : y + height;
+	return r->x0 < r->x1 && r->y0 < r->y1;
+}
+
+static void add_damage(int16_t x, int16_t y, int16_t width, int16_t height)
+{
+	struct modex_rect r;
+	if(!clip(x, y, width, height, &r))return;
+
+	if(damage_count < MODEX_DAMAGE_RECTS)
+	{
+		damage[damage_count++] = r;
+		return;
+	}
+
+	//List is full, keep a single rectangle around everything
+	for(uint8_t i = 0; i < damage_count; i++)
+	{
+		if(damage[i].x0 < r.x0)r.x0 = damage[i].x0;
+		if(damage[i].y0 < r.y0)r.y0 = damage[i].y0;
+		if(damage[i].x1 > r.x1)r.x1 = damage[i].x1;
+		if(damage[i].y1 > r.y1)r.y1 = damage[i].y1;
+	}
+	damage[0] = r;
+	damage_count = 1;
+}
+
+static bool mx_init(void)
+{
+	modex_init();
+	damage_count = 0;
+	for(uint8_t i = 0; i < MODEX_IMAGE_SLOTS; i++)slots[i].sprite = NULL;
+	return true;
+}
+
+static void mx_clear(void)
+{
+	modex_fill_rect(0, MODEX_TOP, RENDERER_WIDTH, RENDERER_HEIGHT, 0x00);
+	damage_count = 0;
+	add_damage(0, 0, RENDERER_WIDTH, RENDERER_HEIGHT);
+}
+
+static void mx_fill_rect(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	struct modex_rect r;
+	if(!clip(x, y, width, height, &r))return;
+
+	modex_fill_rect(r.x0, MODEX_TOP + r.y0, r.x1 - r.x0, r.y1 - r.y0, color);
+	add_damage(r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0);
+}
+
+static void mx_draw_frame(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	if(width == 0 || height == 0)return;
+
+	mx_fill_rect(x, y, width, 1, color);
+	mx_fill_rect(x, y + height - 1, width, 1, color);
+	if(height > 2)
+	{
+		mx_fill_rect(x, y + 1, 1, height - 2, color);
+		mx_fill_rect(x + width - 1, y + 1, 1, height - 2, color);
+	}
+}
+
+//Off-screen copy of a sprite, stored on first use, NULL if it does not fit
+static const struct modex_image *find_image(const struct sprite *sprite)
+{
+	for(uint8_t i = 0; i < MODEX_IMAGE_SLOTS; i++)
+	{
+		struct modex_slot *slot = &slots[i];
+		if(slot->sprite == sprite)return slot->stored ? &slot->image : NULL;
+		if(slot->sprite == NULL)
+		{
+			slot->sprite = sprite;
+			slot->stored = modex_store_sprite(&slot->image, sprite, 0x00);
+			return slot->stored ? &slot->image : NULL;
+		}
+	}
+	return NULL;
+}
+
+static void mx_draw_sprite(const struct sprite *sprite, int16_t x, int16_t y)
+{
+	if(sprite == NULL)return;
+
+	//Sprites land one row below y, like in mode 13h
+	if((x & 3) == 0 && x >= 0 && y + 1 >= 0 && x + sprite->width <= RENDERER_WIDTH
+		&& y + 1 + sprite->height <= RENDERER_HEIGHT
+		&& sprite->width * sprite->height >= MODEX_LATCH_MIN_PIXELS)
+	{
+		const struct modex_image *image = find_image(sprite);
+		if(image != NULL)
+		{
+			modex_blit_image(image, x, MODEX_TOP + y);
+			add_damage(x, y + 1, image->width, image->height);
+			return;
+		}
+	}
+
+	modex_draw_sprite(sprite, x, MODEX_TOP + y);
+	add_damage(x, y + 1, sprite->width, sprite->height);
+}
+
+static void mx_blit_tile(uint16_t x, uint16_t y, uint8_t tile)
+{
+	const struct renderer_tile *look = renderer_get_tile(tile);
+	x *= TILE_SIZE;
+	y *= TILE_SIZE;
+
+	//Same placement as the mode 13h renderer
+	mx_fill_rect(x, y + 1, TILE_SIZE, TILE_SIZE, 0x00);
+	if(look->sprite != NULL)mx_draw_sprite(look->sprite, x, y);
+}
+
+static void mx_draw_text(int16_t x, int16_t y, uint8_t color, const char *text)
+{
+	if(x < 0 || y < 0 || x >= RENDERER_WIDTH || y + 8 > RENDERER_HEIGHT)return;
+
+	modex_puts(x, MODEX_TOP + y, color, 0x00, text);
+	add_damage(x, y, strlen(text) * 9, 8);
+}
+
+//Flip, then give the new hidden page what the old one got since the last flip
+static void mx_present(void)
+{
+	modex_flip();
+
+	//The flip returns at the start of the retrace
+	palette_flush();
+
+	for(uint8_t i = 0; i < damage_count; i++)
+	{
+		struct modex_rect *r = &damage[i];
+		modex_copy_visible(r->x0, MODEX_TOP + r->y0, r->x1 - r->x0, r->y1 - r->y0);
+	}
+	damage_count = 0;
+}
+
+const struct renderer renderer_modex =
+{
+	"modex",
+	mx_init,
+	mx_clear,
+	mx_fill_rect,
+	mx_draw_frame,
+	mx_blit_tile,
+	mx_draw_sprite,
+	mx_draw_text,
+	mx_present,
+};
@@ -0,0 +1,181 @@
+/*
+ * VGA text mode renderer.
+ * Uses the 80x25 text mode the machine boots in, so it needs neither a
+ * mode switch nor the BIOS. Every 8x8 pixel cell of the game becomes two
+ * characters side by side. Drawing goes into a cell buffer, present only
+ * writes the 16 bit cells that changed to 0xB8000.
+ * Sprites have no character equivalent and are left out, palette fades do
+ * not reach the text colors.
+ */
+#include "renderer.h"
+
+#include "stdio.h"
+#include "video.h"
+#include "vga.h"
+#include "tilemap.h"
+
+#define TEXT_WIDTH 80
+#define TEXT_HEIGHT 25
+//Pixels per character
+#define TEXT_CELL_WIDTH (RENDERER_WIDTH / TEXT_WIDTH)
+#define TEXT_CELL_HEIGHT (RENDERER_HEIGHT / TEXT_HEIGHT)
+
+//Code page 437 box drawing characters
+#define BOX_HORIZONTAL  0xC4
+#define BOX_VERTICAL    0xB3
+#define BOX_TOP_LEFT    0xDA
+#define BOX_TOP_RIGHT   0xBF
+#define BOX_BOTTOM_LEFT 0xC0
+#define BOX_BOTTOM_RIGHT 0xD9
+
+//CRTC cursor start register, bit 5 turns the cursor off
+#define VGA_CRTC_CURSOR_START 0x0A
+#define CURSOR_DISABLE 0x20
+
+//Character in the low byte, background and foreground color in the high byte
+#define CELL(c, foreground, background) ((uint16_t)(uint8_t)(c) | ((uint16_t)(((background) << 4) | (foreground)) << 8))
+#define BLANK CELL(' ', 0x07, 0x00)
+
+static volatile uint16_t *const text_memory = (volatile uint16_t *)0xB8000;
+
+//What the game drew and what the screen shows
+static uint16_t cells[TEXT_HEIGHT][TEXT_WIDTH];
+static uint16_t shown[TEXT_HEIGHT][TEXT_WIDTH];
+
+static inline void put_cell(int16_t x, int16_t y, uint16_t cell)
+{
+	if(x < 0 || y < 0 || x >= TEXT_WIDTH || y >= TEXT_HEIGHT)return;
+	cells[y][x] = cell;
+}
+
+//Cells a pixel rectangle touches, false if there are none
+static bool cell_rect(int16_t x, int16_t y, uint16_t width, uint16_t height,
+	int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1)
+{
+	if(width == 0 || height == 0)return false;
+	*x0 = x / TEXT_CELL_WIDTH;
+	*y0 = y / TEXT_CELL_HEIGHT;
+	*x1 = (x + width + TEXT_CELL_WIDTH - 1) / TEXT_CELL_WIDTH;
+	*y1 = (y + height + TEXT_CELL_HEIGHT - 1) / TEXT_CELL_HEIGHT;
+	return true;
+}
+
+static void text_clear(void)
+{
+	for(uint16_t y = 0; y < TEXT_HEIGHT; y++)
+	{
+		for(uint16_t x = 0; x < TEXT_WIDTH; x++)cells[y][x] = BLANK;
+	}
+}
+
+static bool text_init(void)
+{
+	if(!video_text_mode_available())return false;
+
+	//Log lines would land on the playfield
+	set_console_output(false);
+
+	outportb(VGA_CRTC_INDEX, VGA_CRTC_CURSOR_START);
+	outportb(VGA_CRTC_DATA, inportb(VGA_CRTC_DATA) | CURSOR_DISABLE);
+
+	//Unknown content, the first present writes every cell
+	text_clear();
+	for(uint16_t y = 0; y < TEXT_HEIGHT; y++)
+	{
+		for(uint16_t x = 0; x < TEXT_WIDTH; x++)shown[y][x] = ~BLANK;
+	}
+	return true;
+}
+
+//Rectangles lower than a character become a line, the rest is filled
+static void text_fill_rect(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	int16_t x0, y0, x1, y1;
+	if(!cell_rect(x, y, width, height, &x0, &y0, &x1, &y1))return;
+
+	uint8_t text_color = renderer_text_color(color);
+	uint16_t cell = CELL(' ', 0x07, text_color & 0x07);
+	if(height < TEXT_CELL_HEIGHT)cell = CELL(BOX_HORIZONTAL, text_color, 0x00);
+	else if(width < TEXT_CELL_WIDTH)cell = CELL(BOX_VERTICAL, text_color, 0x00);
+
+	for(int16_t cy = y0; cy < y1; cy++)
+	{
+		for(int16_t cx = x0; cx < x1; cx++)put_cell(cx, cy, cell);
+	}
+}
+
+static void text_draw_frame(int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	int16_t x0, y0, x1, y1;
+	if(!cell_rect(x, y, width, height, &x0, &y0, &x1, &y1))return;
+
+	uint8_t text_color = renderer_text_color(color);
+	x1--;
+	y1--;
+	for(int16_t cx = x0 + 1; cx < x1; cx++)
+	{
+		put_cell(cx, y0, CELL(BOX_HORIZONTAL, text_color, 0x00));
+		put_cell(cx, y1, CELL(BOX_HORIZONTAL, text_color, 0x00));
+	}
+	for(int16_t cy = y0 + 1; cy < y1; cy++)
+	{
+		put_cell(x0, cy, CELL(BOX_VERTICAL, text_color, 0x00));
+		put_cell(x1, cy, CELL(BOX_VERTICAL, text_color, 0x00));
+	}
+	put_cell(x0, y0, CELL(BOX_TOP_LEFT, text_color, 0x00));
+	put_cell(x1, y0, CELL(BOX_TOP_RIGHT, text_color, 0x00));
+	put_cell(x0, y1, CELL(BOX_BOTTOM_LEFT, text_color, 0x00));
+	put_cell(x1, y1, CELL(BOX_BOTTOM_RIGHT, text_color, 0x00));
+}
+
+static void text_blit_tile(uint16_t x, uint16_t y, uint8_t tile)
+{
+	const struct renderer_tile *look = renderer_get_tile(tile);
+	uint16_t cell = CELL(look->glyph, renderer_text_color(look->color), 0x00);
+
+	int16_t cx = x * (TILE_SIZE / TEXT_CELL_WIDTH);
+	int16_t cy = y * (TILE_SIZE / TEXT_CELL_HEIGHT);
+	for(int16_t i = 0; i < TILE_SIZE / TEXT_CELL_WIDTH; i++)put_cell(cx + i, cy, cell);
+}
+
+static void text_draw_sprite(const struct sprite *sprite, int16_t x, int16_t y)
+{
+}
+
+//Characters are half as wide as in mode 13h, the text keeps its center
+static void text_draw_text(int16_t x, int16_t y, uint8_t color, const char *text)
+{
+	int16_t length = strlen(text);
+	int16_t center = x + length * TILE_SIZE / 2;
+	int16_t cx = center / TEXT_CELL_WIDTH - length / 2;
+	int16_t cy = y / TEXT_CELL_HEIGHT;
+
+	uint8_t text_color = renderer_text_color(color);
+	for(int16_t i = 0; i < length; i++)put_cell(cx + i, cy, CELL(text[i], text_color, 0x00));
+}
+
+static void text_present(void)
+{
+	for(uint16_t y = 0; y < TEXT_HEIGHT; y++)
+	{
+		for(uint16_t x = 0; x < TEXT_WIDTH; x++)
+		{
+			if(cells[y][x] == shown[y][x])continue;
+			text_memory[y * TEXT_WIDTH + x] = cells[y][x];
+			shown[y][x] = cells[y][x];
+		}
+	}
+}
+
+const struct renderer renderer_text =
+{
+	"text",
+	text_init,
+	text_clear,
+	text_fill_rect,
+	text_draw_frame,
+	text_blit_tile,
+	text_draw_sprite,
+	text_draw_text,
+	text_present,
+};
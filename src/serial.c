@@ -5,25 +5,48 @@
 //@TODO very crude :(
 void init_serial()
 {
-	outportb(COM1 + 1, 0x00);    // Disable all interrupts
-	outportb(COM1 + 3, 0x80);    // Enable DLAB (set baud rate divisor)
-	outportb(COM1 + 0, 0x03);    // Set divisor to 3 (lo byte) 38400 baud
-	outportb(COM1 + 1, 0x00);    //                  (hi byte)
-	outportb(COM1 + 3, 0x03);    // 8 bits, no parity, one stop bit
-	outportb(COM1 + 2, 0xC7);    // Enable FIFO, clear them, with 14-byte threshold
-	outportb(COM1 + 4, 0x0B);    // IRQs enabled, RTS/DSR set
+	init_serial_port(COM1, SERIAL_DIVISOR_38400);
+}
+
+//The baud rate is 115200 / divisor
+void init_serial_port(uint16_t port, uint16_t divisor)
+{
+	while ((inportb(port + 5) & 0x40) == 0); // Let queued bytes go out at the old rate
+	outportb(port + 1, 0x00);    // Disable all interrupts
+	outportb(port + 3, 0x80);    // Enable DLAB (set baud rate divisor)
+	outportb(port + 0, divisor & 0xFF); // Set divisor (lo byte)
+	outportb(port + 1, divisor >> 8);   //             (hi byte)
+	outportb(port + 3, 0x03);    // 8 bits, no parity, one stop bit
+	outportb(port + 2, 0xC7);    // Enable FIFO, clear them, with 14-byte threshold
+	outportb(port + 4, 0x0B);    // IRQs enabled, RTS/DSR set
+}
+
+//Raise the port's IRQ when a byte arrived, COM1 and COM3 use IRQ 4, COM2 and COM4 IRQ 3
+void serial_enable_receive_irq(uint16_t port)
+{
+	outportb(port + 1, 0x01);
 }
 
 int serial_received()
 {
-	return inportb(COM1 + 5) & 1;
+	return serial_received_port(COM1);
+}
+
+int serial_received_port(uint16_t port)
+{
+	return inportb(port + 5) & 1;
 }
 
 char read_serial()
 {
-	while (serial_received() == 0);
+	return read_serial_port(COM1);
+}
+
+char read_serial_port(uint16_t port)
+{
+	while (serial_received_port(port) == 0);
 
-	return inportb(COM1);
+	return inportb(port);
 }
 
 int is_transmit_empty()
@@ -33,7 +56,12 @@ int is_transmit_empty()
 
 void write_serial(char a)
 {
-	while (is_transmit_empty() == 0);
+	write_serial_port(COM1, a);
+}
+
+void write_serial_port(uint16_t port, char a)
+{
+	while ((inportb(port + 5) & 0x20) == 0);
 
-	outportb(COM1, a);
+	outportb(port, a);
 }
@@ -0,0 +1,225 @@
+/*
+ * Simple slab allocator on top of the page allocator.
+ * Every slab is one page. The slab header lives at the start of the page,
+ * followed by the objects. Free objects are chained through their first word.
+ */
+#include "slab.h"
+
+#include "mm.h"
+#include "stdio.h"
+
+struct slab
+{
+	struct kmem_cache *cache;
+	struct slab *prev;
+	struct slab *next;
+	void *free_list;
+	uint32_t in_use;
+};
+
+static struct kmem_cache caches[KMEM_MAX_CACHES];
+static int cache_count = 0;
+
+//kmalloc size classes, kmalloc_caches[0] holds KMALLOC_MIN_SIZE objects
+static struct kmem_cache *kmalloc_caches[9];
+static const char *kmalloc_names[9] = {
+	"kmalloc-8", "kmalloc-16", "kmalloc-32", "kmalloc-64", "kmalloc-128",
+	"kmalloc-256", "kmalloc-512", "kmalloc-1024", "kmalloc-2048"
+};
+
+static void slab_list_remove(struct slab **list, struct slab *slab)
+{
+	if(slab->prev != NULL)slab->prev->next = slab->next;
+	else *list = slab->next;
+
+	if(slab->next != NULL)slab->next->prev = slab->prev;
+
+	slab->prev = NULL;
+	slab->next = NULL;
+}
+
+static void slab_list_push(struct slab **list, struct slab *slab)
+{
+	slab->prev = NULL;
+	slab->next = *list;
+	if(*list != NULL)(*list)->prev = slab;
+	*list = slab;
+}
+
+static struct slab *slab_create(struct kmem_cache *cache)
+{
+	struct slab *slab = (struct slab *) mm_alloc();
+	if(slab == NULL)return NULL;
+
+	slab->cache = cache;
+	slab->prev = NULL;
+	slab->next = NULL;
+	slab->in_use = 0;
+
+	//Chain all objects into the free list
+	uint8_t *object = (uint8_t *)slab + cache->first_object;
+	slab->free_list = object;
+	for(uint32_t i = 0; i < cache->objects_per_slab - 1; i++)
+	{
+		*(void **)object = object + cache->object_size;
+		object += cache->object_size;
+	}
+	*(void **)object = NULL;
+
+	cache->slab_count++;
+	return slab;
+}
+
+void init_slab(void)
+{
+	uint32_t size = KMALLOC_MIN_SIZE;
+	for(int i = 0; size <= KMALLOC_MAX_SIZE; i++)
+	{
+		kmalloc_caches[i] = kmem_cache_create(kmalloc_names[i], size);
+		size <<= 1;
+	}
+}
+
+struct kmem_cache *kmem_cache_create(const char *name, uint32_t object_size)
+{
+	if(cache_count == KMEM_MAX_CACHES)
+	{
+		printf("slab: no free cache descriptor for %s\n", name);
+		return NULL;
+	}
+
+	//Objects have to hold the free list pointer and stay word aligned
+	if(object_size < sizeof(void *))object_size = sizeof(void *);
+	object_size = (object_size + 3) & ~3;
+
+	uint32_t first_object = (sizeof(struct slab) + 7) & ~7;
+	if(object_size > PAGE_SIZE - first_object)
+	{
+		printf("slab: object size %d of %s exceeds a page\n", object_size, name);
+		return NULL;
+	}
+
+	struct kmem_cache *cache = &caches[cache_count++];
+	cache->name = name;
+	cache->object_size = object_size;
+	cache->first_object = first_object;
+	cache->objects_per_slab = (PAGE_SIZE - first_object) / object_size;
+	cache->partial = NULL;
+	cache->full = NULL;
+	cache->empty = NULL;
+	cache->slab_count = 0;
+	cache->objects_in_use = 0;
+
+	return cache;
+}
+
+void *kmem_cache_alloc_site(struct kmem_cache *cache, const char *site)
+{
+	struct slab *slab = cache->partial;
+	if(slab == NULL)
+	{
+		//Reuse the cached empty slab before asking for a new page
+		slab = cache->empty;
+		if(slab != NULL)slab_list_remove(&cache->empty, slab);
+		else slab = slab_create(cache);
+
+		if(slab == NULL)return NULL;
+		slab_list_push(&cache->partial, slab);
+	}
+
+	void *object = slab->free_list;
+	slab->free_list = *(void **)object;
+	slab->in_use++;
+	cache->objects_in_use++;
+
+	if(slab->free_list == NULL)
+	{
+		slab_list_remove(&cache->partial, slab);
+		slab_list_push(&cache->full, slab);
+	}
+
+	memtrack_alloc(object, cache->object_size, site);
+	return object;
+}
+
+void kmem_cache_free(struct kmem_cache *cache, void *object)
+{
+	if(object == NULL)return;
+
+	struct slab *slab = (struct slab *)((uintptr_t)object & ~(PAGE_SIZE - 1));
+	if(slab->cache != cache)
+	{
+		printf("slab: 0x%p does not belong to %s\n", object, cache->name);
+		return;
+	}
+
+	memtrack_free(object);
+
+	if(slab->free_list == NULL)
+	{
+		slab_list_remove(&cache->full, slab);
+		slab_list_push(&cache->partial, slab);
+	}
+
+	*(void **)object = slab->free_list;
+	slab->free_list = object;
+	slab->in_use--;
+	cache->objects_in_use--;
+
+	if(slab->in_use == 0)
+	{
+		slab_list_remove(&cache->partial, slab);
+
+		//Keep one empty slab around, give the rest back to the page allocator
+		if(cache->empty == NULL)
+		{
+			slab_list_push(&cache->empty, slab);
+		}
+		else
+		{
+			cache->slab_count--;
+			mm_free(slab);
+		}
+	}
+}
+
+void *kmalloc_site(size_t size, const char *site)
+{
+	if(size > KMALLOC_MAX_SIZE)
+	{
+		printf("kmalloc: %d Bytes is larger than the biggest size class\n", size);
+		return NULL;
+	}
+
+	int index = 0;
+	uint32_t class_size = KMALLOC_MIN_SIZE;
+	while(class_size < size)
+	{
+		class_size <<= 1;
+		index++;
+	}
+
+	return kmem_cache_alloc_site(kmalloc_caches[index], site);
+}
+
+void kfree(void *object)
+{
+	if(object == NULL)return;
+
+	struct slab *slab = (struct slab *)((uintptr_t)object & ~(PAGE_SIZE - 1));
+	kmem_cache_free(slab->cache, object);
+}
+
+void kmem_print_stats(void)
+{
+	for(int i = 0; i < cache_count; i++)
+	{
+		struct kmem_cache *cache = &caches[i];
+		uint32_t capacity = cache->slab_count * cache->objects_per_slab;
+		uint32_t utilization = 0;
+		if(capacity != 0)utilization = cache->objects_in_use * 100 / capacity;
+
+		printf("slab: %s size=%d slabs=%d objects=%d/%d utilization=%d%%\n", cache->name,
+			cache->object_size, cache->slab_count, cache->objects_in_use, capacity, utilization);
+	}
+}
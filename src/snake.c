@@ -1,12 +1,19 @@
 #include "snake.h"
 
 #include "mm.h"
+#include "slab.h"
+#include "arena.h"
+#include "tilemap.h"
+#include "sprite.h"
 #include "stdlib.h"
 #include "stdint.h"
 #include "bios_int.h"
 #include "video.h"
+#include "palette.h"
 #include "rtc.h"
 #include "stdio.h"
+#include "renderer.h"
+#include "profile.h"
 
 // Because our screen is always 320x200
 // we have a playable field of 40x25
@@ -18,7 +25,17 @@
 #define KEYBOARD_LEFT 0x4B
 #define KEYBOARD_RIGHT 0x4D
 
-#define MENU_TICK_DELAY 250
+// Key polling and palette animation interval in menus
+#define MENU_TICK_DELAY 20
+
+// Screen transitions fade through black
+#define FADE_DURATION 300
+
+// Palette entries 248-255 are black in the default palette, they hold a
+// color ramp that is cycled to make menu text pulse
+#define HIGHLIGHT_COLOR 248
+#define HIGHLIGHT_COLORS 8
+#define HIGHLIGHT_PERIOD 60
 
 #define SNAKE_DEFAULT 1
 #define SNAKE_HEAD 2
@@ -32,6 +49,11 @@
 #define SNAKE_DIRECTION_SOUTH 3
 #define SNAKE_DIRECTION_EAST 4
 
+// Tile ids of the playfield, head and body are ordered north, east, south, west
+#define TILE_APPLE 1
+#define TILE_SNAKE_HEAD 2
+#define TILE_SNAKE_BODY 6
+
 void run_menu(void);
 void run_game(void);
 void run_game_over(void);
@@ -41,25 +63,28 @@ void translate_snake(void);
 void spawn_food(void);
 unsigned long maxrand(unsigned long seed, unsigned long max);
 void busy_wait(uint32_t duration);
+void run_palette_fade(void);
+void wait_for_key(void);
+
+static const uint8_t highlight_ramp[HIGHLIGHT_COLORS][3] =
+{
+  {255, 255, 255}, {255, 255, 192}, {255, 255, 128}, {255, 240, 64},
+  {255, 224, 0}, {255, 240, 64}, {255, 255, 128}, {255, 255, 192},
+};
 
 // Sprites
-uint8_t sprite_snake_head_0 [64] = {0x24, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x2f, 0xf, 0x2f, 0x2f, 0xf, 0x2f, 0x2f, 0x76, 0x2f, 0x0, 0x2f, 0x2f, 0x0, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x76, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x24, 0x24, 0x29, 0x28, 0x24, 0x24, 0x24};
-uint8_t sprite_snake_head_1 [64] = {0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x2f, 0x2f, 0xf, 0x0, 0x2f, 0x2f, 0x2f, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x28, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x29, 0x2f, 0x2f, 0xf, 0x0, 0x2f, 0x2f, 0x76, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x24, 0x24, 0x24, 0x24, 0x76, 0x76, 0x76, 0x24, 0x24, 0x24};
-uint8_t sprite_snake_head_2 [64] = {0x24, 0x24, 0x24, 0x28, 0x29, 0x24, 0x24, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x76, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x0, 0x2f, 0x2f, 0x0, 0x2f, 0x76, 0x2f, 0x2f, 0xf, 0x2f, 0x2f, 0xf, 0x2f, 0x76, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x24};
-uint8_t sprite_snake_head_3 [64] = {0x24, 0x24, 0x24, 0x76, 0x76, 0x76, 0x24, 0x24, 0x24, 0x24, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x24, 0x76, 0x2f, 0x2f, 0x0, 0xf, 0x2f, 0x2f, 0x29, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x28, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x2f, 0x2f, 0x2f, 0x0, 0xf, 0x2f, 0x2f, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x24, 0x24};
+const uint8_t sprite_snake_head [64] = {0x24, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x2f, 0xf, 0x2f, 0x2f, 0xf, 0x2f, 0x2f, 0x76, 0x2f, 0x0, 0x2f, 0x2f, 0x0, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x76, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x24, 0x24, 0x29, 0x28, 0x24, 0x24, 0x24};
 
-uint8_t sprite_snake_body_0 [64] = {0x24, 0x24, 0x76, 0x76, 0x76, 0x76, 0x24, 0x24, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x76, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x76, 0x2f, 0x76, 0x76, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24};
-uint8_t sprite_snake_body_1 [64] = {0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x76, 0x76, 0x76, 0x2f, 0x24, 0x24};
-uint8_t sprite_snake_body_2 [64] = {0x24, 0x24, 0x76, 0x76, 0x76, 0x76, 0x24, 0x24, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x76, 0x76, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24};
-uint8_t sprite_snake_body_3 [64] = {0x24, 0x24, 0x2f, 0x76, 0x76, 0x76, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x24, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x76, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24};
+const uint8_t sprite_snake_body [64] = {0x24, 0x24, 0x76, 0x76, 0x76, 0x76, 0x24, 0x24, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x76, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x76, 0x2f, 0x76, 0x76, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24};
+const uint8_t sprite_snake_body_south [64] = {0x24, 0x24, 0x76, 0x76, 0x76, 0x76, 0x24, 0x24, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x2f, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x76, 0x2f, 0x76, 0x76, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x24, 0x24};
 
-uint8_t sprite_apple [64] = {0x24, 0x24, 0x70, 0x28, 0x28, 0x28, 0x24, 0x24, 0x24, 0x70, 0x28, 0x28, 0x28, 0x28, 0x28, 0x24, 0x24, 0x70, 0x28, 0x28, 0xf, 0x28, 0x28, 0x24, 0x24, 0x70, 0x28, 0x28, 0x28, 0xf, 0x28, 0x24, 0x24, 0x24, 0x70, 0x70, 0x28, 0x28, 0x24, 0x24, 0x24, 0x24, 0x24, 0xc0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0xc0, 0x2, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x2, 0x2, 0x24, 0x24};
+const uint8_t sprite_apple [64] = {0x24, 0x24, 0x70, 0x28, 0x28, 0x28, 0x24, 0x24, 0x24, 0x70, 0x28, 0x28, 0x28, 0x28, 0x28, 0x24, 0x24, 0x70, 0x28, 0x28, 0xf, 0x28, 0x28, 0x24, 0x24, 0x70, 0x28, 0x28, 0x28, 0xf, 0x28, 0x24, 0x24, 0x24, 0x70, 0x70, 0x28, 0x28, 0x24, 0x24, 0x24, 0x24, 0x24, 0xc0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0xc0, 0x2, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x2, 0x2, 0x24, 0x24};
 
-uint8_t sprite_snake_logo [1024] = {0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x2f, 0x2f, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x2f, 0x2f, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x3f, 0x3f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x3f, 0x3f, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x3f, 0x3f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x3f, 0x3f, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24};
+const uint8_t sprite_snake_logo [1024] = {0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x2f, 0x2f, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x2f, 0x2f, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x3f, 0x3f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x3f, 0x3f, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x3f, 0x3f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x3f, 0x3f, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x76, 0x76, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x2f, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24};
 
-uint8_t sprite_credits [200] = {0x80, 0x24, 0x24, 0x24, 0x80, 0x24, 0x82, 0x82, 0x82, 0x82, 0x24, 0x86, 0x24, 0x24, 0x86, 0x24, 0x88, 0x88, 0x88, 0x88, 0x24, 0x8a, 0x24, 0x24, 0x24, 0x24, 0x8c, 0x8c, 0x8c, 0x8c, 0x24, 0x8d, 0x8d, 0x8d, 0x8d, 0x24, 0x8f, 0x24, 0x24, 0x24, 0x20, 0x24, 0x24, 0x24, 0x20, 0x24, 0x22, 0x24, 0x24, 0x22, 0x24, 0x26, 0x24, 0x24, 0x26, 0x24, 0x28, 0x24, 0x24, 0x28, 0x24, 0x2a, 0x24, 0x24, 0x24, 0x24, 0x2c, 0x24, 0x24, 0x24, 0x24, 0x2d, 0x24, 0x24, 0x2d, 0x24, 0x2f, 0x24, 0x24, 0x24, 0x20, 0x24, 0x20, 0x24, 0x20, 0x24, 0x22, 0x24, 0x24, 0x22, 0x24, 0x26, 0x24, 0x26, 0x26, 0x24, 0x28, 0x24, 0x24, 0x28, 0x24, 0x2a, 0x2a, 0x24, 0x24, 0x24, 0x2c, 0x24, 0x24, 0x24, 0x24, 0x2d, 0x24, 0x24, 0x2d, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x20, 0x20, 0x24, 0x20, 0x20, 0x24, 0x22, 0x24, 0x24, 0x22, 0x24, 0x26, 0x26, 0x24, 0x26, 0x24, 0x28, 0x24, 0x24, 0x28, 0x24, 0x2a, 0x24, 0x24, 0x24, 0x24, 0x2c, 0x24, 0x24, 0x24, 0x24, 0x2d, 0x24, 0x24, 0x2d, 0x24, 0x2f, 0x24, 0x24, 0x2f, 0x20, 0x24, 0x24, 0x24, 0x20, 0x24, 0x22, 0x22, 0x22, 0x22, 0x24, 0x26, 0x24, 0x24, 0x26, 0x24, 0x28, 0x28, 0x28, 0x28, 0x24, 0x2a, 0x2a, 0x2a, 0x2a, 0x24, 0x2c, 0x24, 0x24, 0x24, 0x24, 0x2d, 0x2d, 0x2d, 0x2d, 0x24, 0x2f, 0x2f, 0x2f, 0x2f};
+const uint8_t sprite_credits [200] = {0x80, 0x24, 0x24, 0x24, 0x80, 0x24, 0x82, 0x82, 0x82, 0x82, 0x24, 0x86, 0x24, 0x24, 0x86, 0x24, 0x88, 0x88, 0x88, 0x88, 0x24, 0x8a, 0x24, 0x24, 0x24, 0x24, 0x8c, 0x8c, 0x8c, 0x8c, 0x24, 0x8d, 0x8d, 0x8d, 0x8d, 0x24, 0x8f, 0x24, 0x24, 0x24, 0x20, 0x24, 0x24, 0x24, 0x20, 0x24, 0x22, 0x24, 0x24, 0x22, 0x24, 0x26, 0x24, 0x24, 0x26, 0x24, 0x28, 0x24, 0x24, 0x28, 0x24, 0x2a, 0x24, 0x24, 0x24, 0x24, 0x2c, 0x24, 0x24, 0x24, 0x24, 0x2d, 0x24, 0x24, 0x2d, 0x24, 0x2f, 0x24, 0x24, 0x24, 0x20, 0x24, 0x20, 0x24, 0x20, 0x24, 0x22, 0x24, 0x24, 0x22, 0x24, 0x26, 0x24, 0x26, 0x26, 0x24, 0x28, 0x24, 0x24, 0x28, 0x24, 0x2a, 0x2a, 0x24, 0x24, 0x24, 0x2c, 0x24, 0x24, 0x24, 0x24, 0x2d, 0x24, 0x24, 0x2d, 0x24, 0x2f, 0x2f, 0x2f, 0x2f, 0x20, 0x20, 0x24, 0x20, 0x20, 0x24, 0x22, 0x24, 0x24, 0x22, 0x24, 0x26, 0x26, 0x24, 0x26, 0x24, 0x28, 0x24, 0x24, 0x28, 0x24, 0x2a, 0x24, 0x24, 0x24, 0x24, 0x2c, 0x24, 0x24, 0x24, 0x24, 0x2d, 0x24, 0x24, 0x2d, 0x24, 0x2f, 0x24, 0x24, 0x2f, 0x20, 0x24, 0x24, 0x24, 0x20, 0x24, 0x22, 0x22, 0x22, 0x22, 0x24, 0x26, 0x24, 0x24, 0x26, 0x24, 0x28, 0x28, 0x28, 0x28, 0x24, 0x2a, 0x2a, 0x2a, 0x2a, 0x24, 0x2c, 0x24, 0x24, 0x24, 0x24, 0x2d, 0x2d, 0x2d, 0x2d, 0x24, 0x2f, 0x2f, 0x2f, 0x2f};
 
-uint8_t sprite_highscore [1156] = {0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2a, 0x2a, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2a, 0x2a, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, };
+const uint8_t sprite_highscore [1156] = {0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2a, 0x2a, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2a, 0x2a, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2a, 0x2a, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x2c, 0x2c, 0xf, 0xf, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2c, 0x2b, 0x2b, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x14, 0x24, 0x24, 0x24, 0x24, 0x24, 0x24, };
 
 struct snake_element {
    uint16_t x;
@@ -69,11 +94,17 @@ struct snake_element {
    struct snake_element *next;
 };
 
-uint8_t screen_buffer[320 * 200];
 bool game_running = true;
 uint64_t random_seed = 0;
 
 struct snake_element *head = NULL;
+struct kmem_cache *snake_cache = NULL;
+
+// Compiled sprites, they live as long as the game
+struct arena sprite_arena;
+struct sprite *logo = NULL;
+struct sprite *credits = NULL;
+struct sprite *highscore_badge = NULL;
 
 uint8_t snake_direction = SNAKE_DIRECTION_EAST;
 uint16_t food_pos_x = 0;
@@ -81,16 +112,29 @@ uint16_t food_pos_y = 0;
 uint16_t difficulty = 0;
 uint16_t score = 0;
 uint16_t highscore = 0;
+uint16_t snake_length = 0;
 volatile uint64_t tick_counter = 0;
 volatile uint8_t last_scancode = 0x0;
 
+// Frame time stages of the game loop
+uint8_t stage_logic = 0;
+uint8_t stage_translate = 0;
+uint8_t stage_draw_snake = 0;
+uint8_t stage_hud = 0;
+uint8_t stage_tilemap = 0;
+uint8_t stage_present = 0;
+
 void snake_init(void)
 {
-  // Change videomode through bios interrupt. 320x200x256
-  regs16_t regs;
-  regs.ax = 0x0013;
-  int32(0x10, &regs);
-  mode_13h_cls();
+  // Mode 13h, text mode or no output at all, picked with renderer=
+  init_renderer();
+
+  // Palette for fades and color cycling, starts with the mode 13h colors
+  init_palette();
+  for(int i = 0; i < HIGHLIGHT_COLORS; i++)
+  {
+    palette_set(HIGHLIGHT_COLOR + i, highlight_ramp[i][0], highlight_ramp[i][1], highlight_ramp[i][2]);
+  }
 
   // Setup periodic PIT interrupt
   // 1000 Hz = each ms
@@ -100,6 +144,38 @@ void snake_init(void)
   outportb(0x40, creg & 0xFF);
   outportb(0x40, creg >> 8);
 
+  // Scratch memory for a single frame, rewound at the end of every frame
+  arena_init(&frame_arena, "frame", FRAME_ARENA_ORDER);
+
+  // Convert all bitmaps into opaque runs once
+  arena_init(&sprite_arena, "sprite", SPRITE_ARENA_ORDER);
+  logo = sprite_compile(&sprite_arena, sprite_snake_logo, 32, 32);
+  credits = sprite_compile(&sprite_arena, sprite_credits, 40, 5);
+  highscore_badge = sprite_compile(&sprite_arena, sprite_highscore, 34, 34);
+
+  // Playfield tiles as sprites and as characters, heads and bodies face north, east, south and west
+  renderer_set_tile(TILE_APPLE, sprite_compile(&sprite_arena, sprite_apple, 8, 8), '@', 0x0C);
+  renderer_set_tile(TILE_SNAKE_HEAD + 0, sprite_compile(&sprite_arena, sprite_snake_head, 8, 8), '^', 0x0A);
+  renderer_set_tile(TILE_SNAKE_HEAD + 1, sprite_compile_oriented(&sprite_arena, sprite_snake_head, 8, 8, SPRITE_ROTATE_90), '>', 0x0A);
+  renderer_set_tile(TILE_SNAKE_HEAD + 2, sprite_compile_oriented(&sprite_arena, sprite_snake_head, 8, 8, SPRITE_ROTATE_180), 'v', 0x0A);
+  renderer_set_tile(TILE_SNAKE_HEAD + 3, sprite_compile_oriented(&sprite_arena, sprite_snake_head, 8, 8, SPRITE_ROTATE_270), '<', 0x0A);
+  renderer_set_tile(TILE_SNAKE_BODY + 0, sprite_compile(&sprite_arena, sprite_snake_body, 8, 8), 'o', 0x02);
+  renderer_set_tile(TILE_SNAKE_BODY + 1, sprite_compile_oriented(&sprite_arena, sprite_snake_body, 8, 8, SPRITE_ROTATE_90), 'o', 0x02);
+  renderer_set_tile(TILE_SNAKE_BODY + 2, sprite_compile(&sprite_arena, sprite_snake_body_south, 8, 8), 'o', 0x02);
+  renderer_set_tile(TILE_SNAKE_BODY + 3, sprite_compile_oriented(&sprite_arena, sprite_snake_body, 8, 8, SPRITE_ROTATE_270), 'o', 0x02);
+  printf("sprites: %d Bytes compiled\n", sprite_arena.used);
+
+  // The profiler overlay and CSV output are turned on with profile=
+  stage_logic = profile_add_stage("logic");
+  stage_translate = profile_add_stage("translate");
+  stage_draw_snake = profile_add_stage("snake");
+  stage_hud = profile_add_stage("hud");
+  stage_tilemap = profile_add_stage("tilemap");
+  stage_present = profile_add_stage("present");
+
+  // Snake elements are packed into slabs instead of using a page each
+  snake_cache = kmem_cache_create("snake_element", sizeof(struct snake_element));
+
   // Seed PRNG
   read_rtc();
   random_seed = seed_from_current_date();
@@ -115,40 +191,53 @@ void snake_init(void)
 
 void run_menu(void)
 {
-  m13hb_cls(screen_buffer);
-  m13hb_draw_buffer(screen_buffer, 320 * 200);
+  memtrack_report("menu");
 
-  // Draw static stuff
-  m13hb_draw_transparent_bitmap(screen_buffer, sprite_snake_logo, 32, 32, 144, 50);
-  m13hb_draw_transparent_bitmap(screen_buffer, sprite_credits, 40, 5, 275, 190);
-  m13hb_printf(screen_buffer, 96, 100, 0x08, 0x00, "i386 Snake Game");
-  m13hb_printf(screen_buffer, 65, 130, 0x0f, 0x00, "Press any key to start!");
-  m13hb_printf(screen_buffer, 2, 2, 0x0f, 0x00, "HIGH SCORE %d", highscore);
-  m13hb_draw_buffer(screen_buffer, 320 * 200);
+  // Fade out whatever was shown before, the menu is drawn in the dark
+  palette_fade_out(0, 0, 0, tick_counter, FADE_DURATION);
+  run_palette_fade();
+  palette_clear_cycles();
 
-  last_scancode = 0;
+  renderer_clear();
+  renderer_present();
 
-  while(1)
-  {
-    busy_wait(MENU_TICK_DELAY);
+  // Draw static stuff
+  renderer_draw_sprite(logo, 144, 50);
+  renderer_draw_sprite(credits, 275, 190);
+  renderer_printf(96, 100, 0x08, "i386 Snake Game");
+  renderer_printf(65, 130, HIGHLIGHT_COLOR, "Press any key to start!");
+  renderer_printf(2, 2, 0x0f, "HIGH SCORE %d", highscore);
+  renderer_present();
 
-    // Check if any key was pressed
-    // printf("last scancode: %d\n", last_scancode);
-    if(last_scancode != 0)
-    {
-      // Any key was pressed or released
-      break;
-    }
-  }
+  palette_add_cycle(HIGHLIGHT_COLOR, HIGHLIGHT_COLORS, HIGHLIGHT_PERIOD, tick_counter);
+  palette_fade_in(tick_counter, FADE_DURATION);
+  run_palette_fade();
+
+  wait_for_key();
 
   // Start game
+  palette_fade_out(0, 0, 0, tick_counter, FADE_DURATION);
+  run_palette_fade();
+  palette_clear_cycles();
   run_game();
 }
 
 void run_game(void)
 {
+  memtrack_report("game");
+
   snake_direction = SNAKE_DIRECTION_EAST;
 
+  // The playfield is retained between frames, only changed cells are drawn
+  renderer_clear();
+  tilemap_reset();
+
+  // Static HUD parts are drawn once
+  renderer_hline(0, 15, RENDERER_WIDTH, 0x0f);
+  renderer_hline(0, 195, RENDERER_WIDTH, 0x0f);
+  uint16_t hud_score = 0xFFFF;
+  uint16_t hud_difficulty = 0xFFFF;
+
   // Add starting snake
   create_snake_element(WORLD_WIDTH / 2, WORLD_HEIGHT / 2, SNAKE_HEAD, SNAKE_FACING_EAST);
   create_snake_element(WORLD_WIDTH / 2 - 1, WORLD_HEIGHT / 2, SNAKE_DEFAULT, SNAKE_FACING_EAST);
@@ -157,10 +246,23 @@ void run_game(void)
   // Spawn initial food
   spawn_food();
 
+  // Every game gets its own frame times
+  profile_reset();
+
+  // Show the first frame while the screen is still black and fade it in
+  draw_snake();
+  tilemap_draw();
+  renderer_present();
+  palette_fade_in(tick_counter, FADE_DURATION);
+  run_palette_fade();
+
   // GameLoop
   game_running = true;
   while(game_running == true)
   {
+    profile_frame_begin();
+    profile_begin(stage_logic);
+
     uint16_t posx = head->x;
     uint16_t posy = head->y;
 
@@ -231,22 +333,42 @@ void run_game(void)
 
       spawn_food();
     }
+    profile_end(stage_logic);
 
     //Translate and draw snake and other objects
     translate_snake();
 
     //Drawing part
-    m13hb_cls(screen_buffer);
-
     draw_snake();
-    m13hb_draw_transparent_bitmap(screen_buffer, sprite_apple, 8, 8, food_pos_x * 8, food_pos_y * 8);
 
-    m13hb_printf(screen_buffer, 2, 2, 0x0f, 0x00, "Score: %d", score);
-    m13hb_printf(screen_buffer, 200, 2, 0x0f, 0x00, "Cherries: %d", difficulty);
-    m13hb_line(screen_buffer, 0, 15, SCREEN_WIDTH, 15, 0x0f);
-    m13hb_line(screen_buffer, 0, 195, SCREEN_WIDTH, 195, 0x0f);
+    // HUD text only changes when food was collected
+    profile_begin(stage_hud);
+    if(score != hud_score)
+    {
+      renderer_printf(2, 2, 0x0f, "Score: %d", score);
+      hud_score = score;
+    }
+    if(difficulty != hud_difficulty)
+    {
+      renderer_printf(200, 2, 0x0f, "Cherries: %d", difficulty);
+      hud_difficulty = difficulty;
+    }
+    profile_end(stage_hud);
 
-    m13hb_draw_buffer(screen_buffer, 320 * 200);
+    profile_begin(stage_tilemap);
+    tilemap_draw();
+    profile_end(stage_tilemap);
+
+    // Lower left corner, above the bottom line
+    profile_draw_overlay(0, 195 - (PROFILE_MAX_STAGES + 1) * 8);
+
+    profile_begin(stage_present);
+    renderer_present();
+    profile_end(stage_present);
+
+    // Everything allocated from the frame arena is gone now
+    arena_reset(&frame_arena);
+    profile_frame_end(snake_length);
 
     //Wait
     int delay = 250 - difficulty * 10;
@@ -262,55 +384,56 @@ void run_game_over(void)
   struct snake_element *ptr = head;
   while(ptr != NULL)
   {
-    ptr = ptr->next;
-    mm_free(&ptr);
+    struct snake_element *next = ptr->next;
+    kmem_cache_free(snake_cache, ptr);
+    ptr = next;
   }
   head = NULL;
+  snake_length = 0;
+
+  kmem_print_stats();
+  mm_print_buddy_stats();
+  printf("arena: %s peak %d Bytes per frame\n", frame_arena.name, frame_arena.peak);
+
+  m13hb_print_present_stats();
+  profile_print_stats();
+  memtrack_report("game over");
 
   difficulty = 0;
   food_pos_x = 0;
   food_pos_y = 0;
 
-  // Draw game over screen
-  m13hb_draw_rect(screen_buffer, 40, 25, 240, 160, 0x0f);
-  m13hb_draw_rect(screen_buffer, 41, 26, 238, 158, 0x00);
+  // Flash the playfield red before the game over screen covers it
+  palette_flash(0xA8, 0x00, 0x00, tick_counter, FADE_DURATION);
+  run_palette_fade();
 
+  // Draw game over screen
+  renderer_fill_rect(41, 26, 238, 158, 0x00);
+  renderer_draw_frame(40, 25, 240, 160, 0x0f);
 
   // Only draw if we have a new highscore
   if(score > highscore)
   {
     highscore = score;
-    m13hb_printf(screen_buffer, 120, 55, 0x29, 0x00, "Game Over");
-    m13hb_draw_transparent_bitmap(screen_buffer, sprite_highscore, 34, 34, 144, 75);
-    m13hb_printf(screen_buffer, 60, 120, 0x0f, 0x00, "!!! New High Score !!!");
-    m13hb_printf(screen_buffer, 100, 160, 0x08, 0x00, "Press any key!");
+    renderer_printf(120, 55, 0x29, "Game Over");
+    renderer_draw_sprite(highscore_badge, 144, 75);
+    renderer_printf(60, 120, 0x0f, "!!! New High Score !!!");
+    renderer_printf(100, 160, HIGHLIGHT_COLOR, "Press any key!");
   }
   else
   {
-    m13hb_printf(screen_buffer, 120, 80, 0x29, 0x00, "Game Over");
-    m13hb_printf(screen_buffer, 100, 110, 0x08, 0x00, "Press any key!");
+    renderer_printf(120, 80, 0x29, "Game Over");
+    renderer_printf(100, 110, HIGHLIGHT_COLOR, "Press any key!");
   }
 
-  m13hb_draw_buffer(screen_buffer, 320 * 200);
+  renderer_present();
+  palette_add_cycle(HIGHLIGHT_COLOR, HIGHLIGHT_COLORS, HIGHLIGHT_PERIOD, tick_counter);
 
   score = 0;
 
   busy_wait(250);
 
-  last_scancode = 0;
-
-  while(1)
-  {
-    busy_wait(MENU_TICK_DELAY);
-
-    // Check if any key was pressed
-    //printf("last scancode: %d\n", last_scancode);
-    if(last_scancode != 0)
-    {
-      // Any key was pressed or released
-      break;
-    }
-  }
+  wait_for_key();
 
   // Start game
   busy_wait(250);
@@ -319,7 +442,7 @@ void run_game_over(void)
 
 void create_snake_element(uint16_t x, uint16_t y, uint8_t flags, uint8_t direction)
 {
-  struct snake_element *snake = (struct snake_element*) mm_alloc();
+  struct snake_element *snake = (struct snake_element*) kmem_cache_alloc(snake_cache);
   if(snake == NULL)
   {
     printf("Allocation of %d Bytes failed.\n", sizeof(struct snake_element));
@@ -332,6 +455,8 @@ void create_snake_element(uint16_t x, uint16_t y, uint8_t flags, uint8_t directi
   snake->y = y;
   snake->flags = flags;
   snake->direction = direction;
+  snake->next = NULL;
+  snake_length++;
 
   //printf("New element x:%d y:%d flags:%d direction:%d\n", snake->x, snake->y, snake->flags, snake->direction);
 
@@ -360,35 +485,30 @@ void create_snake_element(uint16_t x, uint16_t y, uint8_t flags, uint8_t directi
   }
 }
 
+uint8_t snake_tile(struct snake_element *element)
+{
+  uint8_t tile = (element->flags & SNAKE_HEAD) ? TILE_SNAKE_HEAD : TILE_SNAKE_BODY;
+  if(element->direction == SNAKE_FACING_EAST)tile += 1;
+  else if(element->direction == SNAKE_FACING_SOUTH)tile += 2;
+  else if(element->direction == SNAKE_FACING_WEST)tile += 3;
+  return tile;
+}
+
+// Update the tile map, unchanged cells are not drawn again
 void draw_snake(void)
 {
+  PROFILE_SCOPE(stage_draw_snake);
   struct snake_element *ptr = head;
-  //printf("Drawing snake\n");
   while(ptr != NULL)
   {
-    //printf("Drawing element x:%d y:%d flags:%d direction:%d\n", ptr->x, ptr->y, ptr->flags, ptr->direction);
-    if(ptr->flags & SNAKE_HEAD)
-    {
-      // Draw sprite rotated
-      if(ptr->direction == SNAKE_FACING_NORTH)m13hb_draw_transparent_bitmap(screen_buffer, sprite_snake_head_0, 8, 8, ptr->x * 8, ptr->y * 8);
-      else if(ptr->direction == SNAKE_FACING_EAST)m13hb_draw_transparent_bitmap(screen_buffer, sprite_snake_head_1, 8, 8, ptr->x * 8, ptr->y * 8);
-      else if(ptr->direction == SNAKE_FACING_SOUTH)m13hb_draw_transparent_bitmap(screen_buffer, sprite_snake_head_2, 8, 8, ptr->x * 8, ptr->y * 8);
-      else if(ptr->direction == SNAKE_FACING_WEST)m13hb_draw_transparent_bitmap(screen_buffer, sprite_snake_head_3, 8, 8, ptr->x * 8, ptr->y * 8);
-    }
-    else if (ptr->flags & SNAKE_DEFAULT)
-    {
-      if(ptr->direction == SNAKE_FACING_NORTH)m13hb_draw_transparent_bitmap(screen_buffer, sprite_snake_body_0, 8, 8, ptr->x * 8, ptr->y * 8);
-      else if(ptr->direction == SNAKE_FACING_EAST)m13hb_draw_transparent_bitmap(screen_buffer, sprite_snake_body_1, 8, 8, ptr->x * 8, ptr->y * 8);
-      else if(ptr->direction == SNAKE_FACING_SOUTH)m13hb_draw_transparent_bitmap(screen_buffer, sprite_snake_body_2, 8, 8, ptr->x * 8, ptr->y * 8);
-      else if(ptr->direction == SNAKE_FACING_WEST)m13hb_draw_transparent_bitmap(screen_buffer, sprite_snake_body_3, 8, 8, ptr->x * 8, ptr->y * 8);
-    }
-
+    tilemap_set(ptr->x, ptr->y, snake_tile(ptr));
     ptr = ptr->next;
   }
 }
 
 void translate_snake(void)
 {
+  PROFILE_SCOPE(stage_translate);
   struct snake_element *ptr = head;
 
   uint16_t prev_pos_x = ptr->x;
@@ -426,6 +546,9 @@ void translate_snake(void)
 
     ptr = ptr->next;
   }
+
+  // The tail left this cell, draw_snake sets it again if an element still covers it
+  tilemap_set(prev_pos_x, prev_pos_y, TILE_EMPTY);
 }
 
 void spawn_food(void)
@@ -449,6 +572,7 @@ void spawn_food(void)
     else ptr = ptr->next;
   }
 
+  tilemap_set(food_pos_x, food_pos_y, TILE_APPLE);
   printf("spawned food at: %dx%d\n", food_pos_x, food_pos_y);
 }
 
@@ -461,7 +585,33 @@ unsigned long maxrand(unsigned long seed, unsigned long max)
 void busy_wait(uint32_t duration)
 {
   uint32_t target = tick_counter + duration;
-  while(tick_counter < target){}
+  while(tick_counter < target)
+  {
+    // Use the idle time to clear frames for mm_alloc_zeroed
+    mm_zero_pool_refill();
+  }
+}
+
+// Run the current palette fade to its end, the DAC is written at every retrace
+void run_palette_fade(void)
+{
+  while(palette_fading())
+  {
+    palette_update(tick_counter);
+    renderer_present();
+  }
+}
+
+// Keep color cycles running until any key is pressed or released
+void wait_for_key(void)
+{
+  last_scancode = 0;
+  while(last_scancode == 0)
+  {
+    palette_update(tick_counter);
+    renderer_present();
+    busy_wait(MENU_TICK_DELAY);
+  }
 }
 
 void on_tick(void)
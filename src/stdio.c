@@ -51,6 +51,11 @@
 static char* BASEADDRESS = (char*)0xb8000;
 static int printf_res = 0;
 
+//Cleared while a terminal owns COM1
+static bool serial_output = true;
+//Cleared while the game draws into the text buffer
+static bool console_output = true;
+
 static int x = 0;
 static int y = 0;
 
@@ -61,6 +66,16 @@ void cls(void)
 	memset(BASEADDRESS, 0x0, 4192);
 }
 
+void set_serial_output(bool enabled)
+{
+	serial_output = enabled;
+}
+
+void set_console_output(bool enabled)
+{
+	console_output = enabled;
+}
+
 void putc(char c)
 {
     if((c == '\n') || (x > 79))
@@ -69,7 +84,7 @@ void putc(char c)
         y++;
 
 		#ifdef KERNEL_COM_OUTPUT
-			write_serial('\n');
+			if(serial_output)write_serial('\n');
 		#endif
     }
 
@@ -80,25 +95,24 @@ void putc(char c)
 
     if (y > 24)
 	{
-        int i;
-        for (i = 0; i < 2 * 24 * 80; i++)
-		{
-            BASEADDRESS[i] = BASEADDRESS[i + 160];
-        }
-
-        for (; i < 2 * 25 * 80; i++)
-		{
-            BASEADDRESS[i] = 0;
+        //memcpy copies forward, the overlap is safe
+        if(console_output)
+        {
+            memcpy(BASEADDRESS, BASEADDRESS + 160, 2 * 24 * 80);
+            memset(BASEADDRESS + 2 * 24 * 80, 0, 2 * 80);
         }
         y--;
     }
 
-    BASEADDRESS[2 * (y * 80 + x)] = c;
-    BASEADDRESS[2 * (y * 80 + x) + 1] = 0x07;
+    if(console_output)
+    {
+        BASEADDRESS[2 * (y * 80 + x)] = c;
+        BASEADDRESS[2 * (y * 80 + x) + 1] = 0x07;
+    }
 
 
 	#ifdef KERNEL_COM_OUTPUT
-		write_serial(c);
+		if(serial_output)write_serial(c);
 	#endif
 
     x++;
@@ -253,26 +267,112 @@ out:
     return printf_res;
 }
 
-void *memset(void *b, int c, int len)
+//Append value to text, returns the new end of text
+static char *format_number(char *text, char *end, unsigned long value, int base)
+{
+    const char* digits = "0123456789abcdefghijklmnopqrstuvwxyz";
+    char buf[33];
+    char* p = buf + 32;
+
+    do {
+        *--p = digits[value % base];
+        value /= base;
+    } while (value);
+
+    while (p < buf + 32 && text < end)*text++ = *p++;
+    return text;
+}
+
+//Formats into text instead of the console, knows %s %d %u %x %p and %%.
+//The result is cut to size - 1 characters and always terminated.
+int vsnprintf(char *text, size_t size, const char *fmt, va_list ap)
+{
+    const char* s;
+    char *p = text;
+    char *end = text + size - 1;
+
+    if (size == 0)return 0;
+
+    while (*fmt && p < end)
+    {
+		if (*fmt == '%')
+		{
+			fmt++;
+			switch (*fmt)
+			{
+                case 's':
+                    s = va_arg(ap, char*);
+                    while (*s && p < end)*p++ = *s++;
+                    break;
+                case 'd':
+                case 'u':
+                    p = format_number(p, end, va_arg(ap, unsigned long int), 10);
+                    break;
+                case 'x':
+                case 'p':
+                    p = format_number(p, end, va_arg(ap, unsigned long int), 16);
+                    break;
+                case '%':
+                    *p++ = '%';
+                    break;
+                case '\0':
+                    goto out;
+                default:
+                    *p++ = '%';
+                    if (p < end)*p++ = *fmt;
+                    break;
+            }
+        }
+        else
+        {
+            *p++ = *fmt;
+        }
+		fmt++;
+    }
+
+out:
+    *p = '\0';
+    return p - text;
+}
+
+size_t strlen(const char *s)
 {
-	unsigned char *p = b;
-	while(len > 0)
+	size_t length = 0;
+	while(s[length])length++;
+	return length;
+}
+
+int strcmp(const char *a, const char *b)
+{
+	while(*a && *a == *b)
 	{
-		*p = c;
-		p++;
-		len--;
+		a++;
+		b++;
 	}
-	return(b);
+	return (uint8_t)*a - (uint8_t)*b;
 }
 
-void memcpy(void * destination, const void * source, size_t num)
+int memcmp(const void *a, const void *b, size_t length)
 {
-   // Typecast source and destination addresses to (uint8_t *)
-   uint8_t *csrc = (uint8_t *)source;
-   uint8_t *cdest = (uint8_t *)destination;
+	const uint8_t *pa = a;
+	const uint8_t *pb = b;
+	for(size_t i = 0; i < length; i++)
+	{
+		if(pa[i] != pb[i])return pa[i] - pb[i];
+	}
+	return 0;
+}
 
-   // Copy contents of source[] to destination[]
-   for(int i = 0; i < num; i++)cdest[i] = csrc[i];
+int strncmp(const char *a, const char *b, size_t length)
+{
+	while(length > 0 && *a && *a == *b)
+	{
+		a++;
+		b++;
+		length--;
+	}
+	if(length == 0)return 0;
+	return (uint8_t)*a - (uint8_t)*b;
 }
 
 uint8_t inportb(uint16_t _port)
@@ -290,11 +390,23 @@ void outportb(uint16_t _port, uint8_t _data)
 uint16_t inport(uint16_t _port)
 {
 	uint16_t ret;
-	__asm__ volatile ("inb %%dx,%%ax":"=a" (ret):"d" (_port));
+	__asm__ volatile ("inw %%dx,%%ax":"=a" (ret):"d" (_port));
 	return ret;
 }
 
 void outport(uint16_t _port, uint16_t _data)
 {
-	__asm__ volatile ("outb %%ax,%%dx": :"d" (_port), "a" (_data));
+	__asm__ volatile ("outw %%ax,%%dx": :"d" (_port), "a" (_data));
+}
+
+uint32_t inportl(uint16_t _port)
+{
+	uint32_t ret;
+	__asm__ volatile ("inl %%dx,%%eax":"=a" (ret):"d" (_port));
+	return ret;
+}
+
+void outportl(uint16_t _port, uint32_t _data)
+{
+	__asm__ volatile ("outl %%eax,%%dx": :"d" (_port), "a" (_data));
 }
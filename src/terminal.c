@@ -0,0 +1,299 @@
+/*
+ * ANSI terminal frontend.
+ * With terminal=com1 on the kernel command line the game is also drawn as
+ * 40x25 characters on a terminal attached to that serial port, e.g. qemu
+ * -serial stdio. The game writes characters into a cell buffer,
+ * terminal_present compares it with what the terminal already shows and
+ * only sends the changed cells. The cursor is moved with an escape code
+ * only if it is not already behind the previous cell, so a game tick
+ * usually costs a few dozen bytes.
+ * Keys typed into the terminal come back with the receive interrupt and
+ * are handed to the game as keyboard scancodes.
+ */
+#include "terminal.h"
+
+#include "stdio.h"
+#include "stdarg.h"
+#include "serial.h"
+#include "cmdline.h"
+
+//Cell color is unknown, forces a color escape code
+#define COLOR_UNKNOWN 0xFF
+
+#define ESC 0x1B
+
+//A cursor escape code takes at least 6 bytes
+#define CURSOR_SKIP_MAX 4
+
+struct terminal_cell
+{
+	char c;
+	uint8_t color;
+};
+
+//What the game drew and what the terminal shows
+static struct terminal_cell cells[TERMINAL_HEIGHT][TERMINAL_WIDTH];
+static struct terminal_cell shown[TERMINAL_HEIGHT][TERMINAL_WIDTH];
+
+static bool enabled = false;
+static uint16_t port = COM1;
+static bool screen_reset = true;
+
+//Terminal cursor and color, cursor_x may be TERMINAL_WIDTH after the last column
+static uint16_t cursor_x = 0;
+static uint16_t cursor_y = 0;
+static uint8_t current_color = COLOR_UNKNOWN;
+static uint32_t sent_bytes = 0;
+
+//Escape sequence parser for received keys
+static uint8_t escape_state = 0;
+
+static inline void put_byte(char c)
+{
+	write_serial_port(port, c);
+	sent_bytes++;
+}
+
+static void put_string(const char *s)
+{
+	while(*s)put_byte(*s++);
+}
+
+static void put_number(uint16_t value)
+{
+	if(value >= 10)put_number(value / 10);
+	put_byte('0' + value % 10);
+}
+
+//terminal=com1 to com4
+void init_terminal(void)
+{
+	const char *option = cmdline_get("terminal");
+	if(option == NULL)return;
+
+	static const uint16_t ports[] = {COM1, COM2, COM3, COM4};
+	if(strncmp(option, "com", 3) != 0 || option[3] < '1' || option[3] > '4' || option[4] != '\0')
+	{
+		printf("terminal: unknown port %s\n", option);
+		return;
+	}
+	port = ports[option[3] - '1'];
+	printf("terminal: drawing to %s\n", option);
+
+	//Log lines would end up between the escape codes
+	if(port == COM1)set_serial_output(false);
+
+	init_serial_port(port, SERIAL_DIVISOR_115200);
+	serial_enable_receive_irq(port);
+	terminal_clear();
+	screen_reset = true;
+	enabled = true;
+}
+
+bool terminal_active(void)
+{
+	return enabled;
+}
+
+void terminal_clear(void)
+{
+	for(uint16_t y = 0; y < TERMINAL_HEIGHT; y++)
+	{
+		for(uint16_t x = 0; x < TERMINAL_WIDTH; x++)
+		{
+			cells[y][x].c = ' ';
+			cells[y][x].color = TERMINAL_WHITE;
+		}
+	}
+}
+
+void terminal_put(uint16_t x, uint16_t y, char c, uint8_t color)
+{
+	if(x >= TERMINAL_WIDTH || y >= TERMINAL_HEIGHT)return;
+	cells[y][x].c = c;
+	cells[y][x].color = color;
+}
+
+void terminal_hline(uint16_t x, uint16_t y, uint16_t w, char c, uint8_t color)
+{
+	for(uint16_t i = 0; i < w; i++)terminal_put(x + i, y, c, color);
+}
+
+//Border of w x h cells, the inside stays as it is
+void terminal_draw_frame(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t color)
+{
+	if(w < 2 || h < 2)return;
+
+	terminal_hline(x, y, w, '-', color);
+	for(uint16_t i = 1; i < h - 1; i++)
+	{
+		terminal_put(x, y + i, '|', color);
+		terminal_put(x + w - 1, y + i, '|', color);
+	}
+	terminal_hline(x, y + h - 1, w, '-', color);
+	terminal_put(x, y, '+', color);
+	terminal_put(x + w - 1, y, '+', color);
+	terminal_put(x, y + h - 1, '+', color);
+	terminal_put(x + w - 1, y + h - 1, '+', color);
+}
+
+//Text is cut at the right edge
+int terminal_printf(uint16_t x, uint16_t y, uint8_t color, const char *fmt, ...)
+{
+	va_list ap;
+	char text[TERMINAL_FORMAT_LENGTH];
+
+	va_start(ap, fmt);
+	int length = vsnprintf(text, TERMINAL_FORMAT_LENGTH, fmt, ap);
+	va_end(ap);
+
+	for(int i = 0; i < length; i++)terminal_put(x + i, y, text[i], color);
+	return length;
+}
+
+static void move_cursor(uint16_t x, uint16_t y)
+{
+	if(x == cursor_x && y == cursor_y)return;
+
+	//Sending a few unchanged cells again is shorter than the escape code
+	if(y == cursor_y && x > cursor_x && x - cursor_x <= CURSOR_SKIP_MAX)
+	{
+		uint16_t i = cursor_x;
+		while(i < x && (shown[y][i].c == ' ' || shown[y][i].color == current_color))i++;
+		if(i == x)
+		{
+			while(cursor_x < x)put_byte(shown[y][cursor_x++].c);
+			return;
+		}
+	}
+
+	//ESC[row;columnH, both start at 1
+	put_byte(ESC);
+	put_byte('[');
+	put_number(y + 1);
+	put_byte(';');
+	put_number(x + 1);
+	put_byte('H');
+	cursor_x = x;
+	cursor_y = y;
+}
+
+static void set_color(uint8_t color)
+{
+	if(color == current_color)return;
+
+	//ESC[0;3Xm or ESC[1;3Xm for the bright variant
+	put_byte(ESC);
+	put_byte('[');
+	put_byte((color & TERMINAL_BRIGHT) ? '1' : '0');
+	put_byte(';');
+	put_byte('3');
+	put_byte('0' + (color & 7));
+	put_byte('m');
+	current_color = color;
+}
+
+//Send the changed cells, returns the number of bytes sent
+uint32_t terminal_present(void)
+{
+	if(!enabled)return 0;
+
+	uint32_t start_bytes = sent_bytes;
+	if(screen_reset)
+	{
+		//Reset colors, hide the cursor and clear the screen
+		put_string("\x1B[0m\x1B[?25l\x1B[2J");
+		for(uint16_t y = 0; y < TERMINAL_HEIGHT; y++)
+		{
+			for(uint16_t x = 0; x < TERMINAL_WIDTH; x++)
+			{
+				shown[y][x].c = ' ';
+				shown[y][x].color = COLOR_UNKNOWN;
+			}
+		}
+		cursor_x = TERMINAL_WIDTH;
+		cursor_y = TERMINAL_HEIGHT;
+		current_color = COLOR_UNKNOWN;
+		screen_reset = false;
+	}
+
+	for(uint16_t y = 0; y < TERMINAL_HEIGHT; y++)
+	{
+		for(uint16_t x = 0; x < TERMINAL_WIDTH; x++)
+		{
+			struct terminal_cell *cell = &cells[y][x];
+			struct terminal_cell *old = &shown[y][x];
+
+			//The color of a space does not show
+			if(cell->c == old->c && (cell->color == old->color || cell->c == ' '))continue;
+
+			move_cursor(x, y);
+			if(cell->c != ' ')set_color(cell->color);
+			put_byte(cell->c);
+			cursor_x++;
+			*old = *cell;
+		}
+	}
+
+	return sent_bytes - start_bytes;
+}
+
+static uint8_t key_scancode(char c)
+{
+	switch(c)
+	{
+		case 'w':
+		case 'W':
+			return TERMINAL_SCANCODE_UP;
+		case 's':
+		case 'S':
+			return TERMINAL_SCANCODE_DOWN;
+		case 'a':
+		case 'A':
+			return TERMINAL_SCANCODE_LEFT;
+		case 'd':
+		case 'D':
+			return TERMINAL_SCANCODE_RIGHT;
+		case '\r':
+		case '\n':
+			return TERMINAL_SCANCODE_ENTER;
+		default:
+			return TERMINAL_SCANCODE_SPACE;
+	}
+}
+
+//Called from the serial IRQ until it returns 0.
+//Arrow keys arrive as ESC [ A to ESC [ D.
+uint8_t terminal_read_key(void)
+{
+	if(!enabled)return 0;
+
+	while(serial_received_port(port))
+	{
+		char c = read_serial_port(port);
+
+		if(escape_state == 1 && c == '[')
+		{
+			escape_state = 2;
+			continue;
+		}
+		if(escape_state == 2)
+		{
+			escape_state = 0;
+			if(c == 'A')return TERMINAL_SCANCODE_UP;
+			if(c == 'B')return TERMINAL_SCANCODE_DOWN;
+			if(c == 'C')return TERMINAL_SCANCODE_RIGHT;
+			if(c == 'D')return TERMINAL_SCANCODE_LEFT;
+			continue;
+		}
+
+		escape_state = 0;
+		if(c == ESC)
+		{
+			escape_state = 1;
+			continue;
+		}
+		return key_scancode(c);
+	}
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Retained tile map over the renderer.
+ * tiles holds what each cell should show, drawn what the renderer shows.
+ * Cells that got a new id are queued once, tilemap_draw only blits the
+ * queued cells that still differ, so a frame costs as much as the number
+ * of changed cells.
+ * The cell arrays of a round come from the pool of pre-cleared frames, a
+ * new round swaps pages instead of clearing them, TILE_EMPTY is 0.
+ */
+#include "tilemap.h"
+
+#include "stdio.h"
+#include "renderer.h"
+#include "mm.h"
+
+#define TILEMAP_CELLS (TILEMAP_WIDTH * TILEMAP_HEIGHT)
+
+//Everything that has to start out zeroed, fits into one frame
+struct tilemap_cells
+{
+	uint8_t tiles[TILEMAP_CELLS];
+	uint8_t drawn[TILEMAP_CELLS];
+	bool dirty[TILEMAP_CELLS];
+};
+
+static struct tilemap_cells *cells = NULL;
+static uint16_t dirty_list[TILEMAP_CELLS];
+static uint16_t dirty_count = 0;
+
+//Forget all tiles, the caller has to clear the renderer as well
+void tilemap_reset(void)
+{
+	if(cells != NULL)mm_free(cells);
+	cells = (struct tilemap_cells *) mm_alloc_zeroed();
+	if(cells == NULL)
+	{
+		printf("tilemap: no memory for the cells\n");
+		while(1){}
+	}
+	dirty_count = 0;
+}
+
+//Cells outside of the map are ignored
+void tilemap_set(uint16_t x, uint16_t y, uint8_t tile)
+{
+	if(x >= TILEMAP_WIDTH || y >= TILEMAP_HEIGHT || tile >= TILEMAP_MAX_TILES)return;
+
+	uint16_t cell = y * TILEMAP_WIDTH + x;
+	if(cells->tiles[cell] == tile)return;
+
+	cells->tiles[cell] = tile;
+	if(!cells->dirty[cell])
+	{
+		cells->dirty[cell] = true;
+		dirty_list[dirty_count++] = cell;
+	}
+}
+
+uint8_t tilemap_get(uint16_t x, uint16_t y)
+{
+	if(x >= TILEMAP_WIDTH || y >= TILEMAP_HEIGHT)return TILE_EMPTY;
+	return cells->tiles[y * TILEMAP_WIDTH + x];
+}
+
+//Blit the changed cells, returns the number of cells drawn
+uint32_t tilemap_draw(void)
+{
+	uint32_t blits = 0;
+	for(uint16_t i = 0; i < dirty_count; i++)
+	{
+		uint16_t cell = dirty_list[i];
+		cells->dirty[cell] = false;
+
+		//Set and reset within the same frame
+		if(cells->tiles[cell] == cells->drawn[cell])continue;
+
+		renderer_blit_tile(cell % TILEMAP_WIDTH, cell / TILEMAP_WIDTH, cells->tiles[cell]);
+		cells->drawn[cell] = cells->tiles[cell];
+		blits++;
+	}
+	dirty_count = 0;
+	return blits;
+}
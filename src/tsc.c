@@ -0,0 +1,72 @@
+#include "tsc.h"
+
+#include "cpu.h"
+#include "stdio.h"
+
+#define PIT_FREQUENCY 1193182
+#define CALIBRATION_MS 10
+
+static uint32_t tsc_khz = 0;
+
+//Measure the TSC against a one-shot countdown of PIT channel 2.
+//Channel 0 keeps running for the game timer, channel 2 is only
+//gated to the PC speaker which stays off.
+void init_tsc(void)
+{
+	uint16_t count = PIT_FREQUENCY * CALIBRATION_MS / 1000;
+
+	//Gate high, speaker off
+	outportb(0x61, (inportb(0x61) & ~0x02) | 0x01);
+
+	//Channel 2, lobyte/hibyte, mode 0 (interrupt on terminal count)
+	outportb(0x43, 0xB0);
+	outportb(0x42, count & 0xFF);
+	outportb(0x42, count >> 8);
+
+	//Restart the countdown by toggling the gate
+	uint8_t gate = inportb(0x61);
+	outportb(0x61, gate & ~0x01);
+	outportb(0x61, gate | 0x01);
+
+	uint64_t start = rdtsc();
+	while(!(inportb(0x61) & 0x20)){}
+	uint64_t end = rdtsc();
+
+	tsc_khz = (uint32_t)(end - start) / CALIBRATION_MS;
+	printf("tsc: %d kHz\n", tsc_khz);
+}
+
+uint32_t tsc_get_khz(void)
+{
+	return tsc_khz;
+}
+
+//Saturates at 0xFFFFFFFF us, about 71 minutes. divl traps with #DE when
+//the quotient does not fit in 32 bit, so milliseconds are divided out
+//first and every step is kept below that.
+uint32_t tsc_cycles_to_us(uint64_t cycles)
+{
+	if(tsc_khz == 0)return 0;
+	if((cycles >> 32) >= tsc_khz)return 0xFFFFFFFF;
+
+	uint32_t ms = div64_32(cycles, tsc_khz);
+	if(ms >= 0xFFFFFFFF / 1000)return 0xFFFFFFFF;
+
+	uint32_t rest = cycles - (uint64_t)ms * tsc_khz;
+	return ms * 1000 + div64_32((uint64_t)rest * 1000, tsc_khz);
+}
+
+uint32_t tsc_mb_per_s(uint64_t bytes, uint64_t cycles)
+{
+	//Keep the divisor inside 32 bit
+	while(cycles >> 32)
+	{
+		cycles >>= 1;
+		bytes >>= 1;
+	}
+	if(cycles == 0)return 0;
+
+	//tsc_khz is cycles per millisecond
+	uint64_t bytes_per_ms = div64_32(bytes * tsc_khz, (uint32_t)cycles);
+	return (uint32_t)((bytes_per_ms * 1000) >> 20);
+}
@@ -0,0 +1,153 @@
+/*
+ * VESA BIOS Extensions 2.0.
+ * Modes are enumerated and set through int32, the info blocks are
+ * placed in the low memory BIOS buffer. Only modes with a linear frame
+ * buffer and 8, 16 or 32 bits per pixel are used.
+ */
+#include "vbe.h"
+
+#include "bios_int.h"
+#include "stdio.h"
+#include "video.h"
+#include "lfb.h"
+
+//Both info blocks share the BIOS buffer
+#define VBE_CONTROLLER_INFO ((struct vbe_controller_info *)BIOS_BUFFER)
+#define VBE_MODE_INFO_OFFSET sizeof(struct vbe_controller_info)
+#define VBE_MODE_INFO ((struct vbe_mode_info *)(BIOS_BUFFER + VBE_MODE_INFO_OFFSET))
+
+//Capability bit 1, the DAC can not be programmed through the VGA ports
+#define VBE_CAP_NOT_VGA 0x02
+
+static uint32_t capabilities = 0;
+
+static inline void *real_mode_pointer(uint32_t segment_offset)
+{
+	return (void *)(uintptr_t)(((segment_offset >> 16) << 4) + (segment_offset & 0xFFFF));
+}
+
+static bool vbe_call(uint16_t function, regs16_t *regs)
+{
+	regs->ax = function;
+	int32(0x10, regs);
+	return regs->ax == VBE_SUCCESS;
+}
+
+//Higher is better: integer scale of the game image first, then color depth,
+//then the smaller mode so less of the screen is border
+static uint32_t mode_score(const struct vbe_mode_info *info)
+{
+	uint32_t scale_x = info->width / SCREEN_WIDTH;
+	uint32_t scale_y = info->height / SCREEN_HEIGHT;
+	uint32_t scale = scale_x < scale_y ? scale_x : scale_y;
+
+	uint32_t area = ((uint32_t)info->width * info->height) >> 8;
+	if(area > 0xFFFF)area = 0xFFFF;
+
+	return (scale << 24) | (info->bpp << 16) | (0xFFFF - area);
+}
+
+//Pick a mode, zero width, height or bpp match anything
+bool vbe_find_mode(uint16_t width, uint16_t height, uint8_t bpp, struct vbe_mode *mode)
+{
+	struct vbe_controller_info *controller = VBE_CONTROLLER_INFO;
+	regs16_t regs;
+
+	memset(controller, 0, sizeof(struct vbe_controller_info));
+	memcpy(controller->signature, "VBE2", 4);
+	memset(&regs, 0, sizeof(regs));
+	regs.es = BIOS_BUFFER >> 4;
+	regs.di = 0;
+	if(!vbe_call(0x4F00, &regs) || controller->signature[0] != 'V' || controller->signature[1] != 'E'
+		|| controller->signature[2] != 'S' || controller->signature[3] != 'A')
+	{
+		printf("vbe: not available\n");
+		return false;
+	}
+	if(controller->version < 0x0200)
+	{
+		printf("vbe: version %x has no linear frame buffer\n", controller->version);
+		return false;
+	}
+	capabilities = controller->capabilities;
+	printf("vbe: version %x, %d KB video memory\n", controller->version, controller->total_memory * 64);
+
+	//The list may live inside the info block, copy it before the next call
+	uint16_t modes[VBE_MAX_MODES];
+	uint32_t count = 0;
+	uint16_t *list = real_mode_pointer(controller->video_modes);
+	while(count < VBE_MAX_MODES && list[count] != 0xFFFF)
+	{
+		modes[count] = list[count];
+		count++;
+	}
+
+	uint32_t best_score = 0;
+	for(uint32_t i = 0; i < count; i++)
+	{
+		memset(&regs, 0, sizeof(regs));
+		regs.es = BIOS_BUFFER >> 4;
+		regs.di = VBE_MODE_INFO_OFFSET;
+		regs.cx = modes[i];
+		if(!vbe_call(0x4F01, &regs))continue;
+
+		struct vbe_mode_info *info = VBE_MODE_INFO;
+		uint16_t required = VBE_MODE_SUPPORTED | VBE_MODE_GRAPHICS | VBE_MODE_LFB;
+		if((info->attributes & required) != required)continue;
+		if(info->bpp == 8 && info->memory_model != VBE_MEMORY_PACKED)continue;
+		if((info->bpp == 16 || info->bpp == 32) && info->memory_model != VBE_MEMORY_DIRECT)continue;
+		if(info->bpp != 8 && info->bpp != 16 && info->bpp != 32)continue;
+		if(info->width < SCREEN_WIDTH || info->height < SCREEN_HEIGHT)continue;
+		//lfb.c refuses wider modes, and by then the mode would be set already
+		if(info->width > LFB_MAX_WIDTH)continue;
+
+		printf("vbe: mode %x %dx%dx%d\n", modes[i], info->width, info->height, info->bpp);
+
+		if(width != 0 && info->width != width)continue;
+		if(height != 0 && info->height != height)continue;
+		if(bpp != 0 && info->bpp != bpp)continue;
+
+		uint32_t score = mode_score(info);
+		if(score <= best_score)continue;
+		best_score = score;
+
+		mode->number = modes[i];
+		mode->width = info->width;
+		mode->height = info->height;
+		mode->pitch = info->pitch;
+		mode->bpp = info->bpp;
+		mode->framebuffer = info->framebuffer;
+		mode->red_position = info->red_position;
+		mode->red_size = info->red_mask_size;
+		mode->green_position = info->green_position;
+		mode->green_size = info->green_mask_size;
+		mode->blue_position = info->blue_position;
+		mode->blue_size = info->blue_mask_size;
+	}
+
+	if(best_score == 0)
+	{
+		printf("vbe: no matching mode\n");
+		return false;
+	}
+	return true;
+}
+
+bool vbe_set_mode(const struct vbe_mode *mode)
+{
+	regs16_t regs;
+	memset(&regs, 0, sizeof(regs));
+	regs.bx = mode->number | VBE_SET_MODE_LFB;
+	if(!vbe_call(0x4F02, &regs))
+	{
+		printf("vbe: setting mode %x failed\n", mode->number);
+		return false;
+	}
+
+	//Palette modes get the mode 13h colors
+	if(mode->bpp == 8 && !(capabilities & VBE_CAP_NOT_VGA))vga_load_default_palette();
+
+	printf("vbe: using mode %x %dx%dx%d, frame buffer at %x\n", mode->number, mode->width, mode->height,
+		mode->bpp, mode->framebuffer);
+	return true;
+}
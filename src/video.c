@@ -5,146 +5,978 @@
 #include "font.h"
 #include "stdarg.h"
 #include "serial.h"
+#include "cpu.h"
+#include "tsc.h"
+#include "paging.h"
+#include "sprite.h"
+#include "vga.h"
+#include "vbe.h"
+#include "lfb.h"
+#include "bios_int.h"
+#include "cmdline.h"
+#include "multiboot.h"
+#include "dispi.h"
+#include "palette.h"
+#include "capture.h"
+#include "vga_palette.h"
+
+#define PRESENT_BENCHMARK_FRAMES 32
+
+//Retraces timed to measure the refresh rate
+#define VSYNC_CALIBRATION_FRAMES 8
+
+//Glyphs are 8 pixels wide with one pixel gap
+#define GLYPH_ADVANCE 9
+//Rendered strings kept around and their maximum length
+#define TEXT_CACHE_SLOTS 8
+#define TEXT_CACHE_MAX_LENGTH 32
+//Longest line m13hb_printf formats
+#define TEXT_FORMAT_LENGTH 64
+
+//Maximum number of rectangles per damage list, further rectangles are merged
+#define DAMAGE_MAX_RECTS 32
+//Pixels a merge may cover that neither rectangle covered
+#define DAMAGE_MERGE_SLACK 64
 
 /////////////////////////////////////////
-//Buffered drawing
+//Damage tracking
 /////////////////////////////////////////
-void m13hb_draw_buffer(uint8_t *buffer, uint64_t size)
+//drawn: everything that may be non-zero in the back buffer, cleared by m13hb_cls
+//damage: everything that differs from VGA memory, copied by m13hb_present
+//The buffer content is unknown at start, so both cover the whole screen.
+struct damage_list
 {
-	memcpy((char *)MODE_13H_MEMORY, buffer, size);
+	uint16_t count;
+	struct m13h_rect rects[DAMAGE_MAX_RECTS];
+};
+
+static struct damage_list drawn = {1, {{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}}};
+static struct damage_list damage = {1, {{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}}};
+static struct m13h_present_stats present_stats;
+
+//With page flipping the hidden page lacks the damage of the last frame
+static bool page_flipping = false;
+static uint8_t draw_page = 0;
+static struct damage_list previous_damage = {1, {{0, 0, SCREEN_WIDTH, SCREEN_HEIGHT}}};
+
+//Cycles between two retraces as measured and as used by m13hb_present, 0 while vsync is off
+static uint32_t measured_retrace_period = 0;
+static uint32_t retrace_period = 0;
+
+static inline uint32_t rect_area(const struct m13h_rect *r)
+{
+	return (uint32_t)(r->x1 - r->x0) * (r->y1 - r->y0);
 }
 
-void m13hb_cls(uint8_t *buffer)
+static inline struct m13h_rect rect_union(const struct m13h_rect *a, const struct m13h_rect *b)
 {
-	memset((char *)buffer, 0, (SCREEN_WIDTH * SCREEN_HEIGHT));
+	struct m13h_rect u;
+	u.x0 = a->x0 < b->x0 ? a->x0 : b->x0;
+	u.y0 = a->y0 < b->y0 ? a->y0 : b->y0;
+	u.x1 = a->x1 > b->x1 ? a->x1 : b->x1;
+	u.y1 = a->y1 > b->y1 ? a->y1 : b->y1;
+	return u;
 }
 
-void m13hb_set_pixel(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color)
+//Pixels the union of a and b covers on top of a and b themselves
+//Overlapping rectangles count their intersection twice, so they always merge.
+static inline int32_t rect_merge_cost(const struct m13h_rect *a, const struct m13h_rect *b)
 {
-	memset((char *)buffer + (y << 8) + (y << 6) + x, color, 1);
+	struct m13h_rect u = rect_union(a, b);
+	return (int32_t)rect_area(&u) - (int32_t)rect_area(a) - (int32_t)rect_area(b);
 }
 
-void m13hb_draw_bmp(uint8_t *buffer, uint8_t *img, uint16_t width, uint16_t height, uint16_t x, uint16_t y)
+static void damage_list_add(struct damage_list *list, struct m13h_rect r)
 {
-	int offset = 0;
-	for(int y_count = height; y_count > 0; y_count--)
+	//Merge with existing rectangles as long as it is cheap
+	bool merged = true;
+	while(merged)
 	{
-		memcpy((char *)buffer + ((y_count + y) * SCREEN_WIDTH) + x, img + (width * offset) , width);
-		offset++;
+		merged = false;
+		for(uint16_t i = 0; i < list->count; i++)
+		{
+			if(rect_merge_cost(&list->rects[i], &r) <= DAMAGE_MERGE_SLACK)
+			{
+				r = rect_union(&list->rects[i], &r);
+				list->rects[i] = list->rects[--list->count];
+				merged = true;
+				break;
+			}
+		}
 	}
-}
 
-void m13hb_draw_transparent_bitmap(uint8_t *buffer, uint8_t *img, uint16_t width, uint16_t height, uint16_t x, uint16_t y)
-{
-	for(int offset = 0; offset < width * height; offset++)
+	if(list->count < DAMAGE_MAX_RECTS)
 	{
-		//36 transparent color
-		if(img[offset] != 36)
+		list->rects[list->count++] = r;
+		return;
+	}
+
+	//List is full, grow the rectangle that gets the least bigger
+	uint16_t best = 0;
+	int32_t best_cost = rect_merge_cost(&list->rects[0], &r);
+	for(uint16_t i = 1; i < list->count; i++)
+	{
+		int32_t cost = rect_merge_cost(&list->rects[i], &r);
+		if(cost < best_cost)
 		{
-			m13hb_set_pixel(buffer, x + offset - ((offset / width) * width), y + height - (offset / width), img[offset]);
+			best = i;
+			best_cost = cost;
 		}
 	}
+	list->rects[best] = rect_union(&list->rects[best], &r);
 }
 
-void m13hb_line(uint8_t *buffer, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint8_t color)
+//Record a changed area of the back buffer, clamped to the screen
+static void m13hb_damage(int32_t x, int32_t y, int32_t width, int32_t height)
 {
-	int i, dx, dy, sdx, sdy, dxabs, dyabs, x, y, px, py;
+	int32_t x1 = x + width;
+	int32_t y1 = y + height;
+	if(x < 0)x = 0;
+	if(y < 0)y = 0;
+	if(x1 > SCREEN_WIDTH)x1 = SCREEN_WIDTH;
+	if(y1 > SCREEN_HEIGHT)y1 = SCREEN_HEIGHT;
+	if(x >= x1 || y >= y1)return;
 
-	dx = x2-x1;      /* the horizontal distance of the line */
-	dy = y2-y1;      /* the vertical distance of the line */
-	dxabs = abs(dx);
-	dyabs = abs(dy);
-	sdx = sgn(dx);
-	sdy = sgn(dy);
-	x = dyabs >> 1;
-	y = dxabs >> 1;
-	px = x1;
-	py = y1;
+	struct m13h_rect r = {x, y, x1, y1};
+	damage_list_add(&drawn, r);
+	damage_list_add(&damage, r);
+}
 
-	uint8_t *VGA = (uint8_t *)0xA0000;
-	VGA[(py << 8)+(py << 6) + px] = color;
+//Pixel write without damage tracking, callers record their bounding box
+static inline void put_pixel(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color)
+{
+	buffer[(y << 8) + (y << 6) + x] = color;
+}
 
-	if (dxabs >= dyabs) /* the line is more horizontal than vertical */
+void m13hb_invalidate(void)
+{
+	m13hb_damage(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+/////////////////////////////////////////
+//Text
+/////////////////////////////////////////
+//font_data expanded into byte masks, 0xFF for every set bit.
+//Each glyph row becomes two 32-bit words, pixel 0 in the lowest byte.
+static uint32_t glyph_masks[128][8][2];
+static bool glyph_masks_ready = false;
+
+struct text_cache_entry
+{
+	uint32_t hash;
+	uint32_t last_used;
+	uint8_t color;
+	uint8_t bg_color;
+	uint8_t length;
+	char text[TEXT_CACHE_MAX_LENGTH + 1];
+	uint8_t pixels[8][TEXT_CACHE_MAX_LENGTH * GLYPH_ADVANCE];
+};
+
+static struct text_cache_entry text_cache[TEXT_CACHE_SLOTS];
+static uint32_t text_cache_clock = 0;
+
+//Unaligned 32-bit stores are fine on x86
+typedef uint32_t unaligned_uint32_t __attribute__((aligned(1), may_alias));
+
+static void build_glyph_masks(void)
+{
+	for(uint16_t c = 0; c < 128; c++)
 	{
-		for(i = 0; i < dxabs; i++)
+		for(uint8_t row = 0; row < 8; row++)
 		{
-			y += dyabs;
-			if(y >= dxabs)
+			uint32_t mask[2] = {0, 0};
+			for(uint8_t px = 0; px < 8; px++)
 			{
-				y -= dxabs;
-				py += sdy;
+				if((font_data[c][row] >> (7 - px)) & 0x1)mask[px >> 2] |= 0xFFU << ((px & 3) * 8);
 			}
+			glyph_masks[c][row][0] = mask[0];
+			glyph_masks[c][row][1] = mask[1];
+		}
+	}
+	glyph_masks_ready = true;
+}
+
+//Draw a glyph with background, two masked stores per row, no damage tracking
+static void draw_glyph_pitch(uint8_t *dest, uint16_t pitch, char c, uint8_t color, uint8_t bg_color)
+{
+	if(!glyph_masks_ready)build_glyph_masks();
+
+	uint32_t fg = color * 0x01010101U;
+	uint32_t bg = bg_color * 0x01010101U;
+	uint32_t (*masks)[2] = glyph_masks[(uint8_t)c & 0x7F];
 
-			px += sdx;
-			m13hb_set_pixel(buffer, px, py, color);
+	for(uint8_t row = 0; row < 8; row++)
+	{
+		unaligned_uint32_t *line = (unaligned_uint32_t *)(dest + row * pitch);
+		line[0] = (fg & masks[row][0]) | (bg & ~masks[row][0]);
+		line[1] = (fg & masks[row][1]) | (bg & ~masks[row][1]);
+	}
+}
+
+static inline void draw_glyph(uint8_t *buffer, char c, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color)
+{
+	draw_glyph_pitch(buffer + y * SCREEN_WIDTH + x, SCREEN_WIDTH, c, color, bg_color);
+}
+
+//Render a string with background, gap columns between glyphs get the background color
+static void draw_text_pitch(uint8_t *dest, uint16_t pitch, const char *s, size_t length, uint8_t color, uint8_t bg_color)
+{
+	for(size_t i = 0; i < length; i++)
+	{
+		draw_glyph_pitch(dest + i * GLYPH_ADVANCE, pitch, s[i], color, bg_color);
+		if(i + 1 < length)
+		{
+			for(uint8_t row = 0; row < 8; row++)dest[row * pitch + i * GLYPH_ADVANCE + 8] = bg_color;
 		}
 	}
-	else /* the line is more vertical than horizontal */
+}
+
+static uint32_t text_hash(const char *s, size_t length, uint8_t color, uint8_t bg_color)
+{
+	//FNV-1a
+	uint32_t hash = 2166136261U;
+	for(size_t i = 0; i < length; i++)hash = (hash ^ (uint8_t)s[i]) * 16777619U;
+	hash = (hash ^ color) * 16777619U;
+	hash = (hash ^ bg_color) * 16777619U;
+	return hash;
+}
+
+//Find the rendered string or render it into the least recently used slot
+static struct text_cache_entry *text_cache_lookup(const char *s, size_t length, uint8_t color, uint8_t bg_color)
+{
+	if(length > TEXT_CACHE_MAX_LENGTH)return NULL;
+
+	uint32_t hash = text_hash(s, length, color, bg_color);
+	struct text_cache_entry *victim = &text_cache[0];
+	text_cache_clock++;
+
+	for(uint8_t i = 0; i < TEXT_CACHE_SLOTS; i++)
 	{
-		for(i = 0; i < dyabs; i++)
+		struct text_cache_entry *entry = &text_cache[i];
+		if(entry->length != 0 && entry->hash == hash && entry->color == color
+			&& entry->bg_color == bg_color && strcmp(entry->text, s) == 0)
 		{
-			x += dxabs;
-			if(x >= dyabs)
-			{
-				x -= dyabs;
-				px += sdx;
-			}
+			entry->last_used = text_cache_clock;
+			return entry;
+		}
+		if(entry->last_used < victim->last_used)victim = entry;
+	}
+
+	victim->hash = hash;
+	victim->last_used = text_cache_clock;
+	victim->color = color;
+	victim->bg_color = bg_color;
+	victim->length = length;
+	memcpy(victim->text, s, length + 1);
+
+	draw_text_pitch(victim->pixels[0], TEXT_CACHE_MAX_LENGTH * GLYPH_ADVANCE, s, length, color, bg_color);
+	return victim;
+}
+
+/////////////////////////////////////////
+//Buffered drawing
+/////////////////////////////////////////
+void m13hb_draw_buffer(uint8_t *buffer, uint64_t size)
+{
+	if(lfb_active())lfb_blit(buffer, 0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+	else memcpy((char *)MODE_13H_MEMORY, buffer, size);
+}
+
+static inline bool in_retrace(void)
+{
+	return (inportb(VGA_INPUT_STATUS) & VGA_RETRACE) != 0;
+}
 
-			py += sdy;
-			m13hb_set_pixel(buffer, px, py, color);
+//Wait for the start of the next vertical retrace, false on timeout
+static bool wait_retrace_start(uint64_t timeout_cycles)
+{
+	uint64_t start = rdtsc();
+	while(in_retrace())
+	{
+		if(rdtsc() - start > timeout_cycles)return false;
+	}
+	while(!in_retrace())
+	{
+		if(rdtsc() - start > timeout_cycles)return false;
+	}
+	return true;
+}
+
+//Measure the refresh rate and turn on vsync, stays off if the
+//retrace bit never toggles
+void m13hb_init_vsync(void)
+{
+	//100 ms are enough for any VGA mode
+	uint64_t timeout = (uint64_t)tsc_get_khz() * 100;
+
+	retrace_period = 0;
+	if(timeout == 0 || !wait_retrace_start(timeout))
+	{
+		printf("vsync: no vertical retrace, presenting unsynchronised\n");
+		return;
+	}
+
+	uint64_t start = rdtsc();
+	for(int i = 0; i < VSYNC_CALIBRATION_FRAMES; i++)
+	{
+		if(!wait_retrace_start(timeout))
+		{
+			printf("vsync: retrace stopped during calibration\n");
+			return;
 		}
 	}
+	measured_retrace_period = (uint32_t)((rdtsc() - start) / VSYNC_CALIBRATION_FRAMES);
+	retrace_period = measured_retrace_period;
+
+	//Refresh rate in 1/100 Hz
+	present_stats.refresh_centihz = div64_32((uint64_t)tsc_get_khz() * 100000, retrace_period);
+	printf("vsync: %d.%d Hz, %d us per frame\n", present_stats.refresh_centihz / 100,
+		present_stats.refresh_centihz % 100, tsc_cycles_to_us(retrace_period));
 }
 
-void m13hb_print_8x8_character(uint8_t *buffer, uint8_t *character, uint16_t x, uint16_t y, uint8_t color)
+void m13hb_set_vsync(bool enabled)
 {
-	for(uint8_t vertical = 0; vertical < 8; vertical++)
+	retrace_period = enabled ? measured_retrace_period : 0;
+}
+
+//Copy the rectangles to the display, returns the number of bytes copied
+static uint32_t copy_rects(uint8_t *buffer, const struct damage_list *list)
+{
+	uint32_t bytes = 0;
+	for(uint16_t i = 0; i < list->count; i++)
 	{
-		uint8_t reversed_order = 7;
-		for(uint8_t horizontal = 0; horizontal < 8; horizontal++)
+		const struct m13h_rect *r = &list->rects[i];
+		uint16_t width = r->x1 - r->x0;
+		uint32_t offset = r->y0 * SCREEN_WIDTH + r->x0;
+
+		if(lfb_active())
+		{
+			lfb_blit(buffer, r->x0, r->y0, width, r->y1 - r->y0);
+		}
+		else if(width == SCREEN_WIDTH)
+		{
+			//Full rows are contiguous
+			memcpy((char *)MODE_13H_MEMORY + offset, buffer + offset, rect_area(r));
+		}
+		else
 		{
-			if((character[vertical] >> reversed_order) & 0x1)
+			for(uint16_t row = r->y0; row < r->y1; row++)
 			{
-				 m13hb_set_pixel(buffer, x + horizontal, y + vertical, color);
+				memcpy((char *)MODE_13H_MEMORY + offset, buffer + offset, width);
+				offset += SCREEN_WIDTH;
 			}
-			reversed_order--;
 		}
+		bytes += rect_area(r);
 	}
+	return bytes;
 }
 
-void m13hb_print_8x8_character_background(uint8_t *buffer, uint8_t *character, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color)
+static void record_present(uint32_t bytes, uint32_t copy_cycles, uint64_t wait_cycles, uint64_t end)
+{
+	if(present_stats.frames == 0)present_stats.first_present_tsc = end;
+	present_stats.last_present_tsc = end;
+	present_stats.frames++;
+	present_stats.last_frame_bytes = bytes;
+	present_stats.total_bytes += bytes;
+	present_stats.last_copy_cycles = copy_cycles;
+	if(copy_cycles > present_stats.max_copy_cycles)present_stats.max_copy_cycles = copy_cycles;
+	present_stats.total_copy_cycles += copy_cycles;
+	present_stats.total_wait_cycles += wait_cycles;
+}
+
+//Draw into the hidden page and show it. The hidden page was last drawn two
+//frames ago, so it gets the damage of the previous frame as well.
+//With vsync the page is shown at the beginning of the vertical retrace.
+static uint32_t present_flip(uint8_t *buffer)
+{
+	//Direct color palette changes damage the whole screen
+	bool palette_changed = palette_flush();
+
+	struct damage_list list = previous_damage;
+	for(uint16_t i = 0; i < damage.count; i++)damage_list_add(&list, damage.rects[i]);
+	previous_damage = damage;
+	damage.count = 0;
+
+	uint64_t copy_start = rdtsc();
+	uint32_t bytes = copy_rects(buffer, &list);
+	uint64_t wait_start = rdtsc();
+
+	if(bytes != 0)
+	{
+		if(retrace_period != 0 && !wait_retrace_start((uint64_t)retrace_period * 2))present_stats.missed_retraces++;
+		dispi_show_page(draw_page);
+		draw_page = (draw_page + 1) % DISPI_PAGES;
+		lfb_set_draw_page(draw_page);
+	}
+
+	uint64_t end = rdtsc();
+	record_present(bytes, (uint32_t)(wait_start - copy_start), end - wait_start, end);
+	if(capture_enabled() && (bytes != 0 || palette_changed))capture_frame(buffer, palette_changed);
+	return bytes;
+}
+
+//Copy the damaged areas and palette changes to the display, returns the
+//number of bytes copied. With vsync the copy starts at the beginning of
+//the vertical retrace.
+uint32_t m13hb_present(uint8_t *buffer)
+{
+	if(page_flipping)return present_flip(buffer);
+
+	uint64_t wait_start = rdtsc();
+	if(retrace_period != 0 && (damage.count != 0 || palette_pending()))
+	{
+		//Two periods without a retrace means the display is gone
+		if(!wait_retrace_start((uint64_t)retrace_period * 2))present_stats.missed_retraces++;
+	}
+	uint64_t copy_start = rdtsc();
+
+	//Palette changes go to the DAC first while the retrace lasts
+	bool palette_changed = palette_flush();
+
+	uint32_t bytes = copy_rects(buffer, &damage);
+	damage.count = 0;
+
+	uint64_t end = rdtsc();
+
+	//The copy ran past the blanking interval, the frame may tear
+	if(retrace_period != 0 && bytes != 0 && !in_retrace())present_stats.missed_retraces++;
+
+	record_present(bytes, (uint32_t)(end - copy_start), copy_start - wait_start, end);
+
+	//Outside of the timed part, capturing is slow
+	if(capture_enabled() && (bytes != 0 || palette_changed))capture_frame(buffer, palette_changed);
+	return bytes;
+}
+
+void m13hb_get_present_stats(struct m13h_present_stats *stats)
+{
+	*stats = present_stats;
+}
+
+void m13hb_print_present_stats(void)
 {
-	for(uint8_t vertical = 0; vertical < 8; vertical++)
+	struct m13h_present_stats *stats = &present_stats;
+	if(stats->frames == 0)return;
+
+	//Presents per second in 1/100 Hz over the time between the first and the last present
+	uint32_t elapsed_us = tsc_cycles_to_us(stats->last_present_tsc - stats->first_present_tsc);
+	uint32_t rate = 0;
+	if(elapsed_us != 0)rate = div64_32((uint64_t)(stats->frames - 1) * 100000000, elapsed_us);
+
+	printf("present: %d frames, last %d Bytes, average %d of %d Bytes per frame\n", stats->frames,
+		stats->last_frame_bytes, div64_32(stats->total_bytes, stats->frames), SCREEN_WIDTH * SCREEN_HEIGHT);
+	printf("present: copy last %d us, max %d us, average %d us, retrace wait average %d us\n",
+		tsc_cycles_to_us(stats->last_copy_cycles), tsc_cycles_to_us(stats->max_copy_cycles),
+		tsc_cycles_to_us(div64_32(stats->total_copy_cycles, stats->frames)),
+		tsc_cycles_to_us(div64_32(stats->total_wait_cycles, stats->frames)));
+	printf("present: vsync %s, display %d.%d Hz, achieved %d.%d Hz, %d missed retraces\n",
+		retrace_period != 0 ? "on" : "off", stats->refresh_centihz / 100, stats->refresh_centihz % 100,
+		rate / 100, rate % 100, stats->missed_retraces);
+}
+
+//Only clears what was drawn since the last clear
+void m13hb_cls(uint8_t *buffer)
+{
+	for(uint16_t i = 0; i < drawn.count; i++)
 	{
-		uint8_t reversed_order = 7;
-		for(uint8_t horizontal = 0; horizontal < 8; horizontal++)
+		struct m13h_rect *r = &drawn.rects[i];
+		uint16_t width = r->x1 - r->x0;
+		uint32_t offset = r->y0 * SCREEN_WIDTH + r->x0;
+
+		if(width == SCREEN_WIDTH)
+		{
+			memset((char *)buffer + offset, 0, rect_area(r));
+		}
+		else
 		{
-			if((character[vertical] >> reversed_order) & 0x1)
+			for(uint16_t row = r->y0; row < r->y1; row++)
 			{
-				m13hb_set_pixel(buffer, x + horizontal, y + vertical, color);
+				memset((char *)buffer + offset, 0, width);
+				offset += SCREEN_WIDTH;
 			}
-			else
+		}
+
+		//The cleared area has to reach the screen as well
+		damage_list_add(&damage, *r);
+	}
+	drawn.count = 0;
+}
+
+/////////////////////////////////////////
+//Primitives
+/////////////////////////////////////////
+//Every primitive is clipped once against this rectangle, it always lies on the screen
+static struct m13h_rect clip = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+
+//Intersect a rectangle with the clip rectangle, false if nothing is left
+static bool clip_rect(int32_t x, int32_t y, int32_t width, int32_t height, struct m13h_rect *r)
+{
+	int32_t x0 = x > clip.x0 ? x : clip.x0;
+	int32_t y0 = y > clip.y0 ? y : clip.y0;
+	int32_t x1 = x + width < clip.x1 ? x + width : clip.x1;
+	int32_t y1 = y + height < clip.y1 ? y + height : clip.y1;
+	if(x0 >= x1 || y0 >= y1)return false;
+
+	r->x0 = x0;
+	r->y0 = y0;
+	r->x1 = x1;
+	r->y1 = y1;
+	return true;
+}
+
+static inline void damage_rect(const struct m13h_rect *r)
+{
+	m13hb_damage(r->x0, r->y0, r->x1 - r->x0, r->y1 - r->y0);
+}
+
+static inline bool in_clip(int32_t x, int32_t y)
+{
+	return x >= clip.x0 && x < clip.x1 && y >= clip.y0 && y < clip.y1;
+}
+
+//Fill an already clipped rectangle, one memset per row or one for full rows
+static void fill_rect(uint8_t *buffer, const struct m13h_rect *r, uint8_t color)
+{
+	uint16_t width = r->x1 - r->x0;
+	uint8_t *line = buffer + r->y0 * SCREEN_WIDTH + r->x0;
+	if(width == SCREEN_WIDTH)
+	{
+		memset(line, color, rect_area(r));
+		return;
+	}
+	for(uint16_t row = r->y0; row < r->y1; row++)
+	{
+		memset(line, color, width);
+		line += SCREEN_WIDTH;
+	}
+}
+
+//Horizontal span from x0 to x1 inclusive, clipped, no damage tracking
+static inline void clipped_span(uint8_t *buffer, int32_t x0, int32_t x1, int32_t y, uint8_t color)
+{
+	if(y < clip.y0 || y >= clip.y1)return;
+	if(x0 < clip.x0)x0 = clip.x0;
+	if(x1 >= clip.x1)x1 = clip.x1 - 1;
+	if(x0 > x1)return;
+	memset(buffer + y * SCREEN_WIDTH + x0, color, x1 - x0 + 1);
+}
+
+//Restrict drawing to a rectangle, it is clamped to the screen
+void m13hb_set_clip(int16_t x, int16_t y, uint16_t width, uint16_t height)
+{
+	clip.x0 = 0;
+	clip.y0 = 0;
+	clip.x1 = SCREEN_WIDTH;
+	clip.y1 = SCREEN_HEIGHT;
+
+	struct m13h_rect r;
+	if(!clip_rect(x, y, width, height, &r))
+	{
+		//Nothing is drawn until the next m13hb_set_clip or m13hb_reset_clip
+		clip.x1 = 0;
+		clip.y1 = 0;
+		return;
+	}
+	clip = r;
+}
+
+void m13hb_reset_clip(void)
+{
+	m13hb_set_clip(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+}
+
+void m13hb_set_pixel(uint8_t *buffer, int16_t x, int16_t y, uint8_t color)
+{
+	if(!in_clip(x, y))return;
+	put_pixel(buffer, x, y, color);
+	m13hb_damage(x, y, 1, 1);
+}
+
+void m13hb_draw_rect(uint8_t *buffer, int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	struct m13h_rect r;
+	if(!clip_rect(x, y, width, height, &r))return;
+	fill_rect(buffer, &r, color);
+	damage_rect(&r);
+}
+
+void m13hb_hline(uint8_t *buffer, int16_t x, int16_t y, uint16_t length, uint8_t color)
+{
+	m13hb_draw_rect(buffer, x, y, length, 1, color);
+}
+
+void m13hb_vline(uint8_t *buffer, int16_t x, int16_t y, uint16_t length, uint8_t color)
+{
+	struct m13h_rect r;
+	if(!clip_rect(x, y, 1, length, &r))return;
+
+	uint8_t *pixel = buffer + r.y0 * SCREEN_WIDTH + r.x0;
+	for(uint16_t row = r.y0; row < r.y1; row++)
+	{
+		*pixel = color;
+		pixel += SCREEN_WIDTH;
+	}
+	damage_rect(&r);
+}
+
+//One pixel wide outline of a rectangle
+void m13hb_draw_frame(uint8_t *buffer, int16_t x, int16_t y, uint16_t width, uint16_t height, uint8_t color)
+{
+	if(width == 0 || height == 0)return;
+
+	m13hb_hline(buffer, x, y, width, color);
+	if(height == 1)return;
+	m13hb_hline(buffer, x, y + height - 1, width, color);
+	if(height == 2)return;
+	m13hb_vline(buffer, x, y + 1, height - 2, color);
+	if(width > 1)m13hb_vline(buffer, x + width - 1, y + 1, height - 2, color);
+}
+
+//Bresenham lines advance along the minor axis floor((major / 2 + i * minor) / major)
+//times in the first i steps
+static inline uint32_t line_advances(uint32_t step, uint32_t major_length, uint32_t minor_length)
+{
+	return div64_32((major_length >> 1) + (uint64_t)step * minor_length, major_length);
+}
+
+//Axis aligned lines become spans. For all others the first and last step
+//inside the clip rectangle are computed up front, so a clipped line has
+//exactly the pixels of the unclipped one and the loop needs no checks.
+void m13hb_line(uint8_t *buffer, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t color)
+{
+	if(y1 == y2)
+	{
+		if(x1 > x2)m13hb_hline(buffer, x2, y1, x1 - x2 + 1, color);
+		else m13hb_hline(buffer, x1, y1, x2 - x1 + 1, color);
+		return;
+	}
+	if(x1 == x2)
+	{
+		if(y1 > y2)m13hb_vline(buffer, x1, y2, y1 - y2 + 1, color);
+		else m13hb_vline(buffer, x1, y1, y2 - y1 + 1, color);
+		return;
+	}
+
+	int32_t dx = x2 - x1;
+	int32_t dy = y2 - y1;
+	bool x_major = abs(dx) >= abs(dy);
+
+	int32_t major = x_major ? x1 : y1;
+	int32_t minor = x_major ? y1 : x1;
+	int32_t major_sign = x_major ? sgn(dx) : sgn(dy);
+	int32_t minor_sign = x_major ? sgn(dy) : sgn(dx);
+	uint32_t major_length = x_major ? abs(dx) : abs(dy);
+	uint32_t minor_length = x_major ? abs(dy) : abs(dx);
+
+	//Clip bounds along both axes, inclusive
+	int32_t major_lo = x_major ? clip.x0 : clip.y0;
+	int32_t major_hi = (x_major ? clip.x1 : clip.y1) - 1;
+	int32_t minor_lo = x_major ? clip.y0 : clip.x0;
+	int32_t minor_hi = (x_major ? clip.y1 : clip.x1) - 1;
+
+	//Steps that keep the major coordinate inside
+	int32_t first = major_sign > 0 ? major_lo - major : major - major_hi;
+	int32_t last = major_sign > 0 ? major_hi - major : major - major_lo;
+
+	//Advances that keep the minor coordinate inside
+	int32_t advance_lo = minor_sign > 0 ? minor_lo - minor : minor - minor_hi;
+	int32_t advance_hi = minor_sign > 0 ? minor_hi - minor : minor - minor_lo;
+	if(advance_hi < 0 || advance_lo > (int32_t)minor_length)return;
+	if(advance_hi > (int32_t)minor_length)advance_hi = minor_length;
+
+	//First step with at least advance_lo advances, last step with at most advance_hi
+	uint32_t error_start = major_length >> 1;
+	if(advance_lo > 0)
+	{
+		int32_t step = div64_32((uint64_t)advance_lo * major_length - error_start + minor_length - 1, minor_length);
+		if(step > first)first = step;
+	}
+	int32_t step = div64_32((uint64_t)(advance_hi + 1) * major_length - error_start - 1, minor_length);
+	if(step < last)last = step;
+
+	if(first < 0)first = 0;
+	if(last > (int32_t)major_length)last = major_length;
+	if(first > last)return;
+
+	//Bresenham state at the first visible step
+	uint32_t advances = line_advances(first, major_length, minor_length);
+	uint32_t error = error_start + first * minor_length - advances * major_length;
+	int32_t major_first = major + major_sign * first;
+	int32_t minor_first = minor + minor_sign * (int32_t)advances;
+	int32_t major_last = major + major_sign * last;
+	int32_t minor_last = minor + minor_sign * (int32_t)line_advances(last, major_length, minor_length);
+
+	int32_t x = x_major ? major_first : minor_first;
+	int32_t y = x_major ? minor_first : major_first;
+	int32_t end_x = x_major ? major_last : minor_last;
+	int32_t end_y = x_major ? minor_last : major_last;
+	int32_t left = x < end_x ? x : end_x;
+	int32_t top = y < end_y ? y : end_y;
+	m13hb_damage(left, top, (x < end_x ? end_x : x) - left + 1, (y < end_y ? end_y : y) - top + 1);
+
+	int32_t major_offset = x_major ? major_sign : major_sign * SCREEN_WIDTH;
+	int32_t minor_offset = x_major ? minor_sign * SCREEN_WIDTH : minor_sign;
+	uint8_t *pixel = buffer + y * SCREEN_WIDTH + x;
+	for(int32_t i = first; i <= last; i++)
+	{
+		*pixel = color;
+		pixel += major_offset;
+		error += minor_length;
+		if(error >= major_length)
+		{
+			error -= major_length;
+			pixel += minor_offset;
+		}
+	}
+}
+
+//The eight symmetric points of a circle, per point checks only if the
+//circle crosses the clip rectangle
+static inline void circle_points(uint8_t *buffer, int32_t cx, int32_t cy, int32_t x, int32_t y, uint8_t color, bool clipped)
+{
+	int32_t points[8][2] =
+	{
+		{cx + x, cy + y}, {cx - x, cy + y}, {cx + x, cy - y}, {cx - x, cy - y},
+		{cx + y, cy + x}, {cx - y, cy + x}, {cx + y, cy - x}, {cx - y, cy - x},
+	};
+	for(int i = 0; i < 8; i++)
+	{
+		if(!clipped || in_clip(points[i][0], points[i][1]))put_pixel(buffer, points[i][0], points[i][1], color);
+	}
+}
+
+//Midpoint circle outline
+void m13hb_circle(uint8_t *buffer, int16_t cx, int16_t cy, uint16_t radius, uint8_t color)
+{
+	struct m13h_rect bounds;
+	int32_t size = 2 * radius + 1;
+	if(!clip_rect(cx - radius, cy - radius, size, size, &bounds))return;
+	bool clipped = rect_area(&bounds) != (uint32_t)(size * size);
+
+	int32_t x = radius;
+	int32_t y = 0;
+	int32_t error = 1 - radius;
+	while(x >= y)
+	{
+		circle_points(buffer, cx, cy, x, y, color, clipped);
+		y++;
+		if(error < 0)error += 2 * y + 1;
+		else
+		{
+			x--;
+			error += 2 * (y - x) + 1;
+		}
+	}
+	damage_rect(&bounds);
+}
+
+//Filled with one span per row, the rows match the outline of m13hb_circle
+void m13hb_fill_circle(uint8_t *buffer, int16_t cx, int16_t cy, uint16_t radius, uint8_t color)
+{
+	struct m13h_rect bounds;
+	int32_t size = 2 * radius + 1;
+	if(!clip_rect(cx - radius, cy - radius, size, size, &bounds))return;
+
+	int32_t x = radius;
+	int32_t y = 0;
+	int32_t error = 1 - radius;
+	while(x >= y)
+	{
+		clipped_span(buffer, cx - x, cx + x, cy + y, color);
+		if(y != 0)clipped_span(buffer, cx - x, cx + x, cy - y, color);
+
+		//x shrinks after this step, y is the widest the rows at cy +- x get
+		if(error >= 0 && x != y)
+		{
+			clipped_span(buffer, cx - y, cx + y, cy + x, color);
+			clipped_span(buffer, cx - y, cx + y, cy - x, color);
+		}
+
+		y++;
+		if(error < 0)error += 2 * y + 1;
+		else
+		{
+			x--;
+			error += 2 * (y - x) + 1;
+		}
+	}
+	damage_rect(&bounds);
+}
+
+//Images are stored bottom-up, image row 0 lands at y + height
+void m13hb_draw_bmp(uint8_t *buffer, uint8_t *img, uint16_t width, uint16_t height, int16_t x, int16_t y)
+{
+	struct m13h_rect r;
+	if(!clip_rect(x, y + 1, width, height, &r))return;
+
+	uint16_t columns = r.x1 - r.x0;
+	for(uint16_t row = r.y0; row < r.y1; row++)
+	{
+		const uint8_t *src = img + (y + height - row) * width + (r.x0 - x);
+		memcpy(buffer + row * SCREEN_WIDTH + r.x0, src, columns);
+	}
+	damage_rect(&r);
+}
+
+void m13hb_draw_transparent_bitmap(uint8_t *buffer, uint8_t *img, uint16_t width, uint16_t height, int16_t x, int16_t y)
+{
+	struct m13h_rect r;
+	if(!clip_rect(x, y + 1, width, height, &r))return;
+
+	for(uint16_t row = r.y0; row < r.y1; row++)
+	{
+		const uint8_t *src = img + (y + height - row) * width - x;
+		uint8_t *dest = buffer + row * SCREEN_WIDTH;
+		for(uint16_t column = r.x0; column < r.x1; column++)
+		{
+			if(src[column] != SPRITE_TRANSPARENT)dest[column] = src[column];
+		}
+	}
+	damage_rect(&r);
+}
+
+//Same placement as m13hb_draw_transparent_bitmap, the sprite covers
+//rows y + 1 to y + height
+void m13hb_draw_sprite(uint8_t *buffer, const struct sprite *sprite, int16_t x, int16_t y)
+{
+	int32_t top = y + 1;
+	int32_t first_row = top < clip.y0 ? clip.y0 - top : 0;
+	int32_t last_row = sprite->height;
+	if(top + last_row > clip.y1)last_row = clip.y1 - top;
+
+	int32_t clip_left = x < clip.x0 ? clip.x0 - x : 0;
+	int32_t clip_right = sprite->width;
+	if(x + clip_right > clip.x1)clip_right = clip.x1 - x;
+
+	if(first_row >= last_row || clip_left >= clip_right)return;
+	bool clipped = (clip_left > 0 || clip_right < sprite->width);
+
+	uint8_t *line = buffer + (top + first_row) * SCREEN_WIDTH + x;
+	for(int32_t row = first_row; row < last_row; row++)
+	{
+		const struct sprite_span *span = sprite->spans + sprite->rows[row];
+		const struct sprite_span *end = sprite->spans + sprite->rows[row + 1];
+		for(; span < end; span++)
+		{
+			int32_t start = span->x;
+			int32_t stop = span->x + span->length;
+			const uint8_t *src = sprite->pixels + span->offset;
+
+			if(clipped)
 			{
-				m13hb_set_pixel(buffer, x + horizontal, y + vertical, bg_color);
+				if(start < clip_left)
+				{
+					src += clip_left - start;
+					start = clip_left;
+				}
+				if(stop > clip_right)stop = clip_right;
+				if(start >= stop)continue;
 			}
 
-			reversed_order--;
+			//Runs are short, a plain loop beats the memcpy call
+			uint8_t *dest = line + start;
+			for(int32_t i = 0; i < stop - start; i++)dest[i] = src[i];
 		}
+		line += SCREEN_WIDTH;
 	}
+
+	m13hb_damage(x + clip_left, top + first_row, clip_right - clip_left, last_row - first_row);
+}
+
+//Copy the part of a source image at x, y that lies inside r, r must already be clipped
+static void copy_clipped(uint8_t *buffer, const uint8_t *src, uint16_t pitch, int32_t x, int32_t y, const struct m13h_rect *r)
+{
+	const uint8_t *line = src + (r->y0 - y) * pitch + (r->x0 - x);
+	uint8_t *dest = buffer + r->y0 * SCREEN_WIDTH + r->x0;
+	for(int32_t row = r->y0; row < r->y1; row++)
+	{
+		memcpy(dest, line, r->x1 - r->x0);
+		line += pitch;
+		dest += SCREEN_WIDTH;
+	}
+}
+
+//Only the pixels inside the clip rectangle are visited
+static void print_8x8_clipped(uint8_t *buffer, uint8_t *character, int32_t x, int32_t y, uint8_t color, uint8_t bg_color, bool background)
+{
+	struct m13h_rect r;
+	if(!clip_rect(x, y, 8, 8, &r))return;
+
+	for(int32_t py = r.y0; py < r.y1; py++)
+	{
+		uint8_t bits = character[py - y];
+		for(int32_t px = r.x0; px < r.x1; px++)
+		{
+			if((bits >> (7 - (px - x))) & 0x1)put_pixel(buffer, px, py, color);
+			else if(background)put_pixel(buffer, px, py, bg_color);
+		}
+	}
+	damage_rect(&r);
+}
+
+void m13hb_print_8x8_character(uint8_t *buffer, uint8_t *character, uint16_t x, uint16_t y, uint8_t color)
+{
+	print_8x8_clipped(buffer, character, x, y, color, 0, false);
+}
+
+void m13hb_print_8x8_character_background(uint8_t *buffer, uint8_t *character, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color)
+{
+	print_8x8_clipped(buffer, character, x, y, color, bg_color, true);
+}
+
+//Glyph and the gap column after it, clipped through a small staging copy when needed
+static void draw_glyph_clipped(uint8_t *buffer, char c, int32_t x, int32_t y, uint8_t color, uint8_t bg_color, bool gap)
+{
+	uint8_t width = gap ? GLYPH_ADVANCE : 8;
+	struct m13h_rect r;
+	if(!clip_rect(x, y, width, 8, &r))return;
+
+	if(r.x1 - r.x0 == width && r.y1 - r.y0 == 8)
+	{
+		draw_glyph(buffer, c, x, y, color, bg_color);
+		if(gap)
+		{
+			for(uint8_t row = 0; row < 8; row++)put_pixel(buffer, x + 8, y + row, bg_color);
+		}
+	}
+	else
+	{
+		uint8_t glyph[8][GLYPH_ADVANCE];
+		draw_glyph_pitch(glyph[0], GLYPH_ADVANCE, c, color, bg_color);
+		for(uint8_t row = 0; row < 8; row++)glyph[row][8] = bg_color;
+		copy_clipped(buffer, glyph[0], GLYPH_ADVANCE, x, y, &r);
+	}
+	damage_rect(&r);
 }
 
 void m13hb_putc(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, char c)
 {
-    m13hb_print_8x8_character_background(buffer, font_data[(uint8_t)c], x, y, color, bg_color);
+	draw_glyph_clipped(buffer, c, x, y, color, bg_color, false);
 }
 
+//Strings are rendered once per text and color pair and blitted afterwards,
+//only the columns and rows inside the clip rectangle are copied
 void m13hb_puts(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, const char* s)
 {
-	while (*s)
+	size_t length = strlen(s);
+	if(length == 0)return;
+
+	struct m13h_rect r;
+	if(!clip_rect(x, y, length * GLYPH_ADVANCE - 1, 8, &r))return;
+
+	struct text_cache_entry *entry = text_cache_lookup(s, length, color, bg_color);
+	if(entry == NULL)
 	{
-		m13hb_putc(buffer, x, y, color, bg_color, *s++);
-		x += 9;
+		//Too long for the cache, draw the glyphs in place
+		for(size_t i = 0; i < length; i++)
+		{
+			draw_glyph_clipped(buffer, s[i], x + i * GLYPH_ADVANCE, y, color, bg_color, i + 1 < length);
+		}
+		return;
 	}
+
+	copy_clipped(buffer, entry->pixels[0], TEXT_CACHE_MAX_LENGTH * GLYPH_ADVANCE, x, y, &r);
+	damage_rect(&r);
 }
 
 void m13hb_putn(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, unsigned long value, int base)
@@ -166,68 +998,48 @@ void m13hb_putn(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color, uint8_t
     m13hb_puts(buffer, x, y, color, bg_color, p);
 }
 
+//Formats the whole line first, so it can be served from the string cache
 int m13hb_printf(uint8_t *buffer, uint16_t x, uint16_t y, uint8_t color, uint8_t bg_color, const char* fmt, ...)
 {
 	va_list ap;
-    const char* s;
-    unsigned long n;
-
-    va_start(ap, fmt);
-    int printf_res = 0;
-    while (*fmt)
-    {
-		if (*fmt == '%')
-		{
-			fmt++;
-			switch (*fmt)
-			{
-                case 's':
-                    s = va_arg(ap, char*);
-                    m13hb_puts(buffer, x, y, color, bg_color, s);
-                    break;
-                case 'd':
-                case 'u':
-                    n = va_arg(ap, unsigned long int);
-                    m13hb_putn(buffer, x, y, color, bg_color, n, 10);
-                    break;
-                case 'x':
-                case 'p':
-                    n = va_arg(ap, unsigned long int);
-                    m13hb_putn(buffer, x, y, color, bg_color, n, 16);
-                    break;
-                case '%':
-                    m13hb_putc(buffer, x, y, color, bg_color, '%');
-                    x += 9;
-                    break;
-                case '\0':
-                    goto out;
-                default:
-                    m13hb_putc(buffer, x, y, color, bg_color, '%');
-                    x += 9;
-                    m13hb_putc(buffer, x, y, color, bg_color, *fmt);
-                    x += 9;
-                    break;
-            }
-        }
-        else
-        {
-            m13hb_putc(buffer, x, y, color, bg_color, *fmt);
-            x += 9;
-        }
-		fmt++;
-    }
+	char text[TEXT_FORMAT_LENGTH];
 
-out:
-    va_end(ap);
+	va_start(ap, fmt);
+	int length = vsnprintf(text, TEXT_FORMAT_LENGTH, fmt, ap);
+	va_end(ap);
 
-    return printf_res;
+	m13hb_puts(buffer, x, y, color, bg_color, text);
+	return length;
 }
 
-void m13hb_draw_rect(uint8_t *buffer, uint16_t x, uint16_t y, uint16_t width, uint16_t heigth, uint8_t color)
+//Time full frame copies to VGA memory with the aperture uncached and
+//write-combined and print the result over serial
+void m13hb_benchmark_present(uint8_t *buffer)
 {
-	for(int i = 0; i < heigth; i++)
+	uint32_t frame_size = SCREEN_WIDTH * SCREEN_HEIGHT;
+
+	if(lfb_active())
 	{
-		memset((char *)buffer + x + y * SCREEN_WIDTH + i * SCREEN_WIDTH, color, width);
+		uint64_t start = rdtsc();
+		for(int i = 0; i < PRESENT_BENCHMARK_FRAMES; i++)m13hb_draw_buffer(buffer, frame_size);
+		uint64_t cycles = rdtsc() - start;
+
+		printf("present lfb scale %d: %d cycles/frame\n", lfb_get_scale(), (uint32_t)(cycles / PRESENT_BENCHMARK_FRAMES));
+		return;
+	}
+
+	for(int pass = 0; pass < 2; pass++)
+	{
+		bool write_combining = (pass == 1);
+		if(write_combining && !paging_write_combining_supported())break;
+		paging_set_write_combining(MODE_13H_MEMORY, frame_size, write_combining);
+
+		uint64_t start = rdtsc();
+		for(int i = 0; i < PRESENT_BENCHMARK_FRAMES; i++)m13hb_draw_buffer(buffer, frame_size);
+		uint64_t cycles = rdtsc() - start;
+
+		printf("present %s: %d cycles/frame, %d MB/s\n", write_combining ? "write-combining" : "uncached",
+			(uint32_t)(cycles / PRESENT_BENCHMARK_FRAMES), tsc_mb_per_s((uint64_t)frame_size * PRESENT_BENCHMARK_FRAMES, cycles));
 	}
 }
 
@@ -236,5 +1048,186 @@ void m13hb_draw_rect(uint8_t *buffer, uint16_t x, uint16_t y, uint16_t width, ui
 /////////////////////////////////////////
 void mode_13h_cls()
 {
-	memset((char *)MODE_13H_MEMORY, 0, (SCREEN_WIDTH * SCREEN_HEIGHT));
+	if(lfb_active())lfb_clear();
+	else memset((char *)MODE_13H_MEMORY, 0, (SCREEN_WIDTH * SCREEN_HEIGHT));
+}
+
+/////////////////////////////////////////
+//Display setup
+/////////////////////////////////////////
+//Frame buffer set up by the boot loader, valid if boot_framebuffer_found
+static struct lfb_format boot_framebuffer;
+static bool boot_framebuffer_found = false;
+//The boot loader left a graphics mode, even one we cannot use
+static bool boot_graphics = false;
+//VBE or DISPI switched modes, the boot frame buffer is not shown anymore
+static bool mode_changed = false;
+
+//Mode 13h colors, the DAC takes 6 bit values
+void vga_load_default_palette(void)
+{
+	outportb(VGA_DAC_WRITE_INDEX, 0);
+	for(int i = 0; i < 256; i++)
+	{
+		outportb(VGA_DAC_DATA, vga_palette[i][0] >> 2);
+		outportb(VGA_DAC_DATA, vga_palette[i][1] >> 2);
+		outportb(VGA_DAC_DATA, vga_palette[i][2] >> 2);
+	}
+}
+
+//Remember the graphics mode the boot loader set, if any
+void init_boot_framebuffer(struct multiboot_info *mb_info)
+{
+	boot_framebuffer_found = false;
+	boot_graphics = false;
+	if(!(mb_info->flags & MULTIBOOT_INFO_FRAMEBUFFER_INFO))return;
+
+	if(mb_info->framebuffer_type == MULTIBOOT_FRAMEBUFFER_TYPE_EGA_TEXT)
+	{
+		printf("video: boot loader stayed in text mode\n");
+		return;
+	}
+	boot_graphics = true;
+	if(mb_info->framebuffer_addr >> 32)
+	{
+		printf("video: boot frame buffer above 4 GB\n");
+		return;
+	}
+
+	boot_framebuffer.base = mb_info->framebuffer_addr;
+	boot_framebuffer.width = mb_info->framebuffer_width;
+	boot_framebuffer.height = mb_info->framebuffer_height;
+	boot_framebuffer.pitch = mb_info->framebuffer_pitch;
+	boot_framebuffer.bpp = mb_info->framebuffer_bpp;
+	if(mb_info->framebuffer_type == MULTIBOOT_FRAMEBUFFER_TYPE_RGB)
+	{
+		boot_framebuffer.red_position = mb_info->framebuffer_red_field_position;
+		boot_framebuffer.red_size = mb_info->framebuffer_red_mask_size;
+		boot_framebuffer.green_position = mb_info->framebuffer_green_field_position;
+		boot_framebuffer.green_size = mb_info->framebuffer_green_mask_size;
+		boot_framebuffer.blue_position = mb_info->framebuffer_blue_field_position;
+		boot_framebuffer.blue_size = mb_info->framebuffer_blue_mask_size;
+	}
+	else if(boot_framebuffer.bpp != 8)
+	{
+		printf("video: indexed boot frame buffer with %d bpp\n", boot_framebuffer.bpp);
+		return;
+	}
+
+	printf("video: boot frame buffer %dx%dx%d, pitch %d\n", boot_framebuffer.width, boot_framebuffer.height,
+		boot_framebuffer.bpp, boot_framebuffer.pitch);
+	boot_framebuffer_found = true;
+}
+
+//Parse WxH or WxHxBPP, missing parts stay zero
+static void parse_resolution(const char *s, uint16_t *width, uint16_t *height, uint8_t *bpp)
+{
+	uint32_t values[3] = {0, 0, 0};
+	for(int i = 0; i < 3; i++)
+	{
+		while(*s >= '0' && *s <= '9')values[i] = values[i] * 10 + (*s++ - '0');
+		if(*s != 'x')break;
+		s++;
+	}
+	*width = values[0];
+	*height = values[1];
+	*bpp = values[2];
+}
+
+static bool init_vbe(const char *request)
+{
+	uint16_t width = 0;
+	uint16_t height = 0;
+	uint8_t bpp = 0;
+	if(request[0] == ':')parse_resolution(request + 1, &width, &height, &bpp);
+
+	struct vbe_mode mode;
+	if(!vbe_find_mode(width, height, bpp, &mode) || !vbe_set_mode(&mode))return false;
+	mode_changed = true;
+
+	struct lfb_format format =
+	{
+		.base = mode.framebuffer,
+		.width = mode.width,
+		.height = mode.height,
+		.pitch = mode.pitch,
+		.bpp = mode.bpp,
+		.red_position = mode.red_position,
+		.red_size = mode.red_size,
+		.green_position = mode.green_position,
+		.green_size = mode.green_size,
+		.blue_position = mode.blue_position,
+		.blue_size = mode.blue_size,
+	};
+	return lfb_init(&format);
+}
+
+static bool init_dispi(const char *request)
+{
+	uint16_t width = 0;
+	uint16_t height = 0;
+	uint8_t bpp = 0;
+	if(request[0] == ':')parse_resolution(request + 1, &width, &height, &bpp);
+
+	struct lfb_format format;
+	if(!dispi_init(width, height, bpp, &format))return false;
+	mode_changed = true;
+	if(!lfb_init(&format))return false;
+	if(format.bpp == 8)vga_load_default_palette();
+
+	//Start drawing into the page that is not shown
+	page_flipping = true;
+	draw_page = 1;
+	lfb_set_draw_page(draw_page);
+	return true;
+}
+
+static bool init_boot_lfb(void)
+{
+	if(!boot_framebuffer_found || !lfb_init(&boot_framebuffer))return false;
+
+	//The boot loader left its own palette in the DAC
+	if(boot_framebuffer.bpp == 8)vga_load_default_palette();
+	return true;
+}
+
+//80x25 text mode at 0xB8000 is still shown unless the boot loader switched away from it
+bool video_text_mode_available(void)
+{
+	return !boot_graphics;
+}
+
+//The display is chosen with video= on the kernel command line:
+//  vbe              VBE mode with the largest integer scale of 320x200
+//  vbe:WxH[xBPP]    a specific VBE mode
+//  dispi            Bochs/QEMU display at 640x400x32 with page flipping
+//  dispi:WxH[xBPP]  the same with a specific mode
+//  vga              BIOS mode 13h
+//Without it, the frame buffer from the boot loader is used if there is one.
+//If everything else fails, BIOS mode 13h is used. The boot frame buffer is
+//skipped once VBE or DISPI changed the mode.
+void init_video(void)
+{
+	const char *video = cmdline_get("video");
+	if(video != NULL && strncmp(video, "vbe", 3) == 0)
+	{
+		if(init_vbe(video + 3))return;
+		printf("video: VBE failed, falling back\n");
+	}
+	if(video != NULL && strncmp(video, "dispi", 5) == 0)
+	{
+		if(init_dispi(video + 5))return;
+		printf("video: DISPI failed, falling back\n");
+	}
+
+	if(!mode_changed && (video == NULL || strcmp(video, "vga") != 0))
+	{
+		if(init_boot_lfb())return;
+	}
+
+	regs16_t regs;
+	memset(&regs, 0, sizeof(regs));
+	regs.ax = 0x0013;
+	int32(0x10, &regs);
+	mode_13h_cls();
 }